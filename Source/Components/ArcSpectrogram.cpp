@@ -190,14 +190,32 @@ void ArcSpectrogram::resized() {
 }
 
 void ArcSpectrogram::run() {
+  // pass type as another thread can change member variable right after run() is
+  // done
+  const ParamUI::SpecType specType = mParameters.ui.specType;
+  mParameters.ui.specImages[specType] = juce::Image(juce::Image::ARGB, getWidth(), getHeight(), true);
+  if (!drawImage(mParameters.ui.specImages[specType], specType)) return;
+
+  onImageComplete(specType);
+  mIsProcessing = false;
+}
+
+juce::Image ArcSpectrogram::renderImage(ParamUI::SpecType specType, void* buffer) {
+  waitForThreadToExit(BUFFER_PROCESS_TIMEOUT);
+  mBuffers[specType] = buffer;
+  juce::Image image(juce::Image::ARGB, getWidth(), getHeight(), true);
+  drawImage(image, specType);
+  return image;
+}
+
+bool ArcSpectrogram::drawImage(juce::Image& image, ParamUI::SpecType specType) {
   // Initialize rainbow parameters
   juce::Point<int> startPoint = juce::Point<int>(getWidth() / 2, getHeight());
-  mParameters.ui.specImages[mParameters.ui.specType] = juce::Image(juce::Image::ARGB, getWidth(), getHeight(), true);
-  juce::Graphics g(mParameters.ui.specImages[mParameters.ui.specType]);
+  juce::Graphics g(image);
 
   // Audio waveform (1D) is handled a bit differently than its 2D spectrograms
-  if (mParameters.ui.specType == ParamUI::SpecType::WAVEFORM) {
-    juce::AudioBuffer<float>* audioBuffer = (juce::AudioBuffer<float>*)mBuffers[mParameters.ui.specType];
+  if (specType == ParamUI::SpecType::WAVEFORM) {
+    juce::AudioBuffer<float>* audioBuffer = (juce::AudioBuffer<float>*)mBuffers[specType];
     const float* bufferSamples = audioBuffer->getReadPointer(0);
     float maxMagnitude = audioBuffer->getMagnitude(0, audioBuffer->getNumSamples());
 
@@ -206,7 +224,7 @@ void ArcSpectrogram::run() {
                                                                       -(juce::MathConstants<float>::pi / 2.0f));
     juce::Colour prevColour = juce::Colours::black;
     for (auto i = 0; i < NUM_COLS; ++i) {
-      if (threadShouldExit()) return;
+      if (threadShouldExit()) return false;
       int sampleIdx = ((float)i / NUM_COLS) * audioBuffer->getNumSamples();
       float sampleRadius =
           juce::jmap(bufferSamples[sampleIdx], -maxMagnitude, maxMagnitude, (float)mStartRadius, (float)mEndRadius);
@@ -227,15 +245,14 @@ void ArcSpectrogram::run() {
     }
   } else {
     // All other types of spectrograms
-    Utils::SpecBuffer& spec = *(Utils::SpecBuffer*)mBuffers[mParameters.ui.specType];  // cast to SpecBuffer
-    if (spec.size() == 0 || threadShouldExit()) return;
+    Utils::SpecBuffer& spec = *(Utils::SpecBuffer*)mBuffers[specType];  // cast to SpecBuffer
+    if (spec.size() == 0 || threadShouldExit()) return false;
 
-    const float maxRow =
-        static_cast<float>((mParameters.ui.specType == ParamUI::SpecType::SPECTROGRAM) ? spec[0].size() / 8 : spec[0].size());
+    const float maxRow = static_cast<float>((specType == ParamUI::SpecType::SPECTROGRAM) ? spec[0].size() / 8 : spec[0].size());
 
     // Draw each column of frequencies
     for (size_t i = 0; i < NUM_COLS; ++i) {
-      if (threadShouldExit()) return;
+      if (threadShouldExit()) return false;
       const float specCol = ((float)i / NUM_COLS) * spec.size();
       // Draw each row of frequencies
       for (auto curRadius = mStartRadius; curRadius < mEndRadius; curRadius += 1) {
@@ -267,11 +284,7 @@ void ArcSpectrogram::run() {
       }
     }
   }
-
-  // pass type as another thread can change member variable right after run() is
-  // done
-  onImageComplete(mParameters.ui.specType);
-  mIsProcessing = false;
+  return true;
 }
 
 void ArcSpectrogram::onImageComplete(ParamUI::SpecType specType) {
@@ -46,6 +46,9 @@ class ArcSpectrogram : public juce::AnimatedAppComponent, juce::Thread {
 
   //============================================================================
   void run() override;
+  // Draws the image for a type on the calling thread the same way run() does, at the component's size. For tools that need the
+  // images without the editor, buffer is what loadSpecBuffer() or loadWaveformBuffer() would have been given.
+  juce::Image renderImage(ParamUI::SpecType specType, void *buffer);
 
   // Callback functions when all images are created
   std::function<void(void)> onImagesComplete = nullptr;
@@ -106,6 +109,8 @@ class ArcSpectrogram : public juce::AnimatedAppComponent, juce::Thread {
 
   juce::ComboBox mSpecType;
 
+  // False if it stopped early or there was nothing to draw
+  bool drawImage(juce::Image &image, ParamUI::SpecType specType);
   void onImageComplete(ParamUI::SpecType specType);
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ArcSpectrogram)
@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    PerfHud.cpp
+    Created: 19 Oct 2026 6:10:33am
+
+  ==============================================================================
+*/
+
+#include "PerfHud.h"
+
+PerfHud::PerfHud() {
+  setInterceptsMouseClicks(false, false);
+  setSize(WIDTH, HEIGHT);
+}
+
+void PerfHud::update(const PerfCounters::Snapshot& snapshot) {
+  mSnapshot = snapshot;
+  repaint();
+}
+
+void PerfHud::paint(juce::Graphics& g) {
+  g.setColour(juce::Colours::black.withAlpha(0.7f));
+  g.fillRoundedRectangle(getLocalBounds().toFloat(), 6.0f);
+  g.setFont(12.0f);
+
+  juce::Rectangle<int> r = getLocalBounds().reduced(PADDING);
+  if (mSnapshot.numBlocks == 0) {
+    g.setColour(juce::Colours::white);
+    g.drawText("No audio processed yet", r, juce::Justification::centred);
+    return;
+  }
+
+  const float deadlineUs = juce::jmax(mSnapshot.deadlineUs, 1.0f);
+  g.setColour(juce::Colours::white);
+  g.drawText("Block " + juce::String(mSnapshot.blockUs, 0) + " us, max " + juce::String(mSnapshot.maxBlockUs, 0) + " of " +
+                 juce::String(deadlineUs, 0) + " us",
+             r.removeFromTop(ROW_HEIGHT), juce::Justification::centredLeft);
+
+  // One bar per stage, full width being the whole deadline
+  for (int stage = 0; stage < PerfCounters::NUM_STAGES; ++stage) {
+    juce::Rectangle<int> row = r.removeFromTop(ROW_HEIGHT);
+    g.setColour(juce::Colours::white);
+    g.drawText(PerfCounters::STAGE_NAMES[stage], row.removeFromLeft(LABEL_WIDTH), juce::Justification::centredLeft);
+    g.drawText(juce::String(mSnapshot.stageUs[stage], 1) + " us", row.removeFromRight(VALUE_WIDTH),
+               juce::Justification::centredRight);
+    const juce::Rectangle<float> bar = row.reduced(2, 3).toFloat();
+    g.setColour(juce::Colours::white.withAlpha(0.2f));
+    g.fillRect(bar);
+    const float share = juce::jlimit(0.0f, 1.0f, mSnapshot.stageUs[stage] / deadlineUs);
+    g.setColour(share > 0.5f ? juce::Colours::orangered : juce::Colours::limegreen);
+    g.fillRect(bar.withWidth(bar.getWidth() * share));
+  }
+
+  r.removeFromTop(PADDING);
+  g.setColour(juce::Colours::white);
+  g.drawText("Grains dropped at the cap: " + juce::String(mSnapshot.totalDrops), r.removeFromBottom(ROW_HEIGHT),
+             juce::Justification::centredLeft);
+
+  const int histogramWidth = r.getWidth() / 3;
+  drawHistogram(g, r.removeFromLeft(histogramWidth), "voices", mSnapshot.voices.data(), PerfCounters::NUM_VOICE_BINS);
+  drawHistogram(g, r.removeFromLeft(histogramWidth), "grains /" + juce::String(mSnapshot.grainsPerBin), mSnapshot.grains.data(),
+                PerfCounters::NUM_GRAIN_BINS);
+  drawHistogram(g, r, "drops/block", mSnapshot.drops.data(), PerfCounters::NUM_DROP_BINS);
+}
+
+void PerfHud::drawHistogram(juce::Graphics& g, juce::Rectangle<int> area, const juce::String& title, const int* bins,
+                            int numBins) const {
+  area.reduce(2, 0);
+  g.setColour(juce::Colours::white);
+  g.drawText(title, area.removeFromBottom(ROW_HEIGHT), juce::Justification::centred);
+  const juce::Rectangle<float> chart = area.toFloat();
+  g.setColour(juce::Colours::white.withAlpha(0.2f));
+  g.fillRect(chart);
+
+  const float binWidth = chart.getWidth() / static_cast<float>(numBins);
+  g.setColour(juce::Colours::skyblue);
+  for (int i = 0; i < numBins; ++i) {
+    const float height = chart.getHeight() * static_cast<float>(bins[i]) / static_cast<float>(mSnapshot.numBlocks);
+    g.fillRect(chart.getX() + binWidth * i, chart.getBottom() - height, juce::jmax(1.0f, binWidth - 1.0f), height);
+  }
+}
@@ -0,0 +1,42 @@
+/*
+  ==============================================================================
+
+    PerfHud.h
+    Created: 19 Oct 2026 6:10:33am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "DSP/PerfCounters.h"
+
+/**
+ * Overlay showing where processBlock's time goes, stage by stage against the block deadline, and histograms of the active voices,
+ * active grains and grains dropped at the cap over the last blocks. Only draws, clicks go through to whatever is under it.
+ */
+class PerfHud : public juce::Component {
+ public:
+  PerfHud();
+
+  void paint(juce::Graphics& g) override;
+
+  void update(const PerfCounters::Snapshot& snapshot);
+
+  static constexpr int WIDTH = 250;
+  static constexpr int HEIGHT = 190;
+
+ private:
+  static constexpr int PADDING = 6;
+  static constexpr int ROW_HEIGHT = 15;
+  static constexpr int LABEL_WIDTH = 70;
+  static constexpr int VALUE_WIDTH = 60;
+
+  // Bar chart of a histogram, each bar as tall as its share of the blocks
+  void drawHistogram(juce::Graphics& g, juce::Rectangle<int> area, const juce::String& title, const int* bins, int numBins) const;
+
+  PerfCounters::Snapshot mSnapshot;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PerfHud)
+};
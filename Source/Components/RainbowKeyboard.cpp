@@ -14,7 +14,8 @@
 #include "Utils/Colour.h"
 
 //==============================================================================
-RainbowKeyboard::RainbowKeyboard(juce::MidiKeyboardState& state, Parameters& parameters) : mState(state), mParameters(parameters) {
+RainbowKeyboard::RainbowKeyboard(Utils::NoteEventFifo& noteEvents, Parameters& parameters)
+    : mNoteEvents(noteEvents), mParameters(parameters) {
   mNoteVelocity.fill(0.0f);
   mRandom.setSeed(juce::Time::currentTimeMillis());
   for (auto& note : mParameters.note.notes) {
@@ -317,11 +318,11 @@ void RainbowKeyboard::updateMouseState(const juce::MouseEvent& e, bool isDown, b
     // Hovering over new note, send note off for old note if necessary
     // Will turn off also if mouse exit keyboard
     if (mMouseNote.pitch != Utils::PitchClass::NONE) {
-      mState.noteOff(MIDI_CHANNEL, mMouseNote.pitch, mMouseNote.velocity);
+      mNoteEvents.pushNoteOff(mMouseNote.pitch);
       mMouseNote = Utils::MidiNote();
     }
     if (isDown && isValidNote) {
-      mState.noteOn(MIDI_CHANNEL, mHoverNote.pitch, mHoverNote.velocity);
+      mNoteEvents.pushNoteOn(mHoverNote.pitch, mHoverNote.velocity);
       mMouseNote = mHoverNote;
       // Select current note for parameter edits and send update
       if (mParameters.selectedParams != mParameters.note.notes[mHoverNote.pitch].get()) {
@@ -332,11 +333,11 @@ void RainbowKeyboard::updateMouseState(const juce::MouseEvent& e, bool isDown, b
   } else {
     if (isDown && (mMouseNote.pitch == Utils::PitchClass::NONE) && isValidNote) {
       // Note on if pressing current note
-      mState.noteOn(MIDI_CHANNEL, mHoverNote.pitch, mHoverNote.velocity);
+      mNoteEvents.pushNoteOn(mHoverNote.pitch, mHoverNote.velocity);
       mMouseNote = mHoverNote;
     } else if ((mMouseNote.pitch != Utils::PitchClass::NONE) && !isDown) {
       // Note off if released current note
-      mState.noteOff(MIDI_CHANNEL, mMouseNote.pitch, mMouseNote.velocity);
+      mNoteEvents.pushNoteOff(mMouseNote.pitch);
       mMouseNote = Utils::MidiNote();
     } else {
       // still update state
@@ -15,6 +15,7 @@
 #include "Parameters.h"
 #include "Utils/Utils.h"
 #include "Utils/MidiNote.h"
+#include "Utils/NoteEventFifo.h"
 #include "Utils/PitchClass.h"
 
 /**
@@ -25,7 +26,7 @@
 */
 class RainbowKeyboard : public juce::Component, juce::AudioProcessorParameter::Listener {
  public:
-  RainbowKeyboard(juce::MidiKeyboardState& state, Parameters& parameters);
+  RainbowKeyboard(Utils::NoteEventFifo& noteEvents, Parameters& parameters);
   ~RainbowKeyboard() override;
 
   void paint(juce::Graphics&) override;
@@ -48,7 +49,6 @@ class RainbowKeyboard : public juce::Component, juce::AudioProcessorParameter::L
   float getPitchXRatio(Utils::PitchClass pitchClass);
 
  private:
-  static constexpr int MIDI_CHANNEL = 1;
   static constexpr float NOTE_BODY_HEIGHT = 0.45f;
   static constexpr float GEN_NODE_HEIGHT = 0.08f;
   static constexpr float NOTE_BODY_SATURATION = 0.5f;
@@ -61,7 +61,7 @@ class RainbowKeyboard : public juce::Component, juce::AudioProcessorParameter::L
 
   // Bookkeeping
   juce::Random mRandom;
-  juce::MidiKeyboardState& mState;
+  Utils::NoteEventFifo& mNoteEvents;  // Mouse injected notes for the audio thread
   Parameters& mParameters;
   // holds the velocity of each pitch class, if zero, then note is not played
   std::array<float, Utils::PitchClass::COUNT> mNoteVelocity;
@@ -16,6 +16,13 @@ void PowerUserSettings::resetParameters() {
   }
 }
 
+void PowerUserSettings::setMultiCoreRender(bool value) {
+  if (mSynth != nullptr) {
+    // Leave a core for the host and everything else
+    mSynth->setNumRenderThreads(value ? juce::SystemStats::getNumPhysicalCpus() - 1 : 1);
+  }
+}
+
 SettingsComponent::SettingsComponent() {
   mBtnAnimation.setButtonText("Run animation");
   mBtnAnimation.setColour(juce::TextButton::buttonColourId, juce::Colours::red);
@@ -36,9 +43,54 @@ SettingsComponent::SettingsComponent() {
   mBtnResourceUsage.setColour(juce::TextButton::buttonOnColourId, juce::Colours::green);
   mBtnResourceUsage.setToggleState(PowerUserSettings::get().getResourceUsage(), juce::NotificationType::dontSendNotification);
   mBtnResourceUsage.setClickingTogglesState(true);
-  mBtnResourceUsage.setToggleState(false, juce::NotificationType::dontSendNotification);
   mBtnResourceUsage.onClick = [this] { PowerUserSettings::get().setResourceUsage(mBtnResourceUsage.getToggleState()); };
   addAndMakeVisible(mBtnResourceUsage);
+
+  mBtnMultiCoreRender.setButtonText("Multi-core render");
+  mBtnMultiCoreRender.setColour(juce::TextButton::buttonColourId, juce::Colours::red);
+  mBtnMultiCoreRender.setColour(juce::TextButton::buttonOnColourId, juce::Colours::green);
+  mBtnMultiCoreRender.setToggleState(PowerUserSettings::get().getMultiCoreRender(), juce::NotificationType::dontSendNotification);
+  mBtnMultiCoreRender.setClickingTogglesState(true);
+  mBtnMultiCoreRender.onClick = [this] { PowerUserSettings::get().setMultiCoreRender(mBtnMultiCoreRender.getToggleState()); };
+  addAndMakeVisible(mBtnMultiCoreRender);
+
+  mSliderMaxVoices.setSliderStyle(juce::Slider::SliderStyle::IncDecButtons);
+  mSliderMaxVoices.setRange(ParamEngine::MIN_VOICES, ParamEngine::MAX_VOICES, 1);
+  mSliderMaxVoices.setTextValueSuffix(" voices");
+  mSliderMaxVoices.setValue(PowerUserSettings::get().getMaxVoices(), juce::NotificationType::dontSendNotification);
+  mSliderMaxVoices.onValueChange = [this] {
+    PowerUserSettings::get().setMaxVoices(static_cast<int>(mSliderMaxVoices.getValue()));
+  };
+  addAndMakeVisible(mSliderMaxVoices);
+
+  for (int i = 0; i < Interpolation::QUALITY_NAMES.size(); ++i) {
+    mInterpolation.addItem(Interpolation::QUALITY_NAMES[i], i + 1);
+  }
+  mInterpolation.setSelectedId(PowerUserSettings::get().getInterpolation() + 1, juce::NotificationType::dontSendNotification);
+  mInterpolation.onChange = [this] { PowerUserSettings::get().setInterpolation(mInterpolation.getSelectedId() - 1); };
+  addAndMakeVisible(mInterpolation);
+
+  mBtnDeterministic.setButtonText("Deterministic");
+  mBtnDeterministic.setColour(juce::TextButton::buttonColourId, juce::Colours::red);
+  mBtnDeterministic.setColour(juce::TextButton::buttonOnColourId, juce::Colours::green);
+  mBtnDeterministic.setToggleState(PowerUserSettings::get().getDeterministic(), juce::NotificationType::dontSendNotification);
+  mBtnDeterministic.setClickingTogglesState(true);
+  mBtnDeterministic.onClick = [this] { PowerUserSettings::get().setDeterministic(mBtnDeterministic.getToggleState()); };
+  addAndMakeVisible(mBtnDeterministic);
+
+  mSeed.setInputRestrictions(18, "0123456789");
+  mSeed.setTextToShowWhenEmpty("Seed", juce::Colours::grey);
+  mSeed.setText(juce::String(PowerUserSettings::get().getSeed()), juce::NotificationType::dontSendNotification);
+  mSeed.onTextChange = [this] { PowerUserSettings::get().setSeed(mSeed.getText().getLargeIntValue()); };
+  addAndMakeVisible(mSeed);
+
+  mOfflineQuality.addItem("Bounce as live", 1);
+  mOfflineQuality.addItem("Bounce best", 2);
+  mOfflineQuality.addItem("Bounce best 2x", 3);
+  mOfflineQuality.addItem("Bounce best 4x", 4);
+  mOfflineQuality.setSelectedId(PowerUserSettings::get().getOfflineQuality() + 1, juce::NotificationType::dontSendNotification);
+  mOfflineQuality.onChange = [this] { PowerUserSettings::get().setOfflineQuality(mOfflineQuality.getSelectedId() - 1); };
+  addAndMakeVisible(mOfflineQuality);
 }
 
 SettingsComponent::~SettingsComponent() {}
@@ -56,4 +108,10 @@ void SettingsComponent::resized() {
   mBtnAnimation.setBounds(r.removeFromTop(buttonHeight).withWidth(buttonWidth));
   mBtnResetParameters.setBounds(r.removeFromTop(buttonHeight).withWidth(buttonWidth));
   mBtnResourceUsage.setBounds(r.removeFromTop(buttonHeight).withWidth(buttonWidth));
+  mBtnMultiCoreRender.setBounds(r.removeFromTop(buttonHeight).withWidth(buttonWidth));
+  mSliderMaxVoices.setBounds(r.removeFromTop(buttonHeight).withWidth(buttonWidth));
+  mInterpolation.setBounds(r.removeFromTop(buttonHeight).withWidth(buttonWidth));
+  mBtnDeterministic.setBounds(r.removeFromTop(buttonHeight).withWidth(buttonWidth));
+  mSeed.setBounds(r.removeFromTop(buttonHeight).withWidth(buttonWidth));
+  mOfflineQuality.setBounds(r.removeFromTop(buttonHeight).withWidth(buttonWidth));
 }
\ No newline at end of file
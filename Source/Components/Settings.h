@@ -19,7 +19,7 @@
 */
 class PowerUserSettings {
  public:
-  PowerUserSettings() : mIsAnimated(true), mIsResourceUsage(true), mSynth(nullptr) {}
+  PowerUserSettings() : mIsAnimated(true), mIsResourceUsage(false), mSynth(nullptr) {}
   ~PowerUserSettings() {}
 
   void setSynth(GranularSynth* synth) { mSynth = synth; }
@@ -27,11 +27,48 @@ class PowerUserSettings {
   void setAnimated(bool value) { mIsAnimated = value; }
   bool getAnimated() { return mIsAnimated; }
 
+  // Shows the processBlock timing overlay in the editor
   void setResourceUsage(bool value) { mIsResourceUsage = value; }
   bool getResourceUsage() { return mIsResourceUsage; }
 
   void resetParameters();
 
+  // Renders voices on a pool of worker threads as well as the audio thread
+  void setMultiCoreRender(bool value);
+  bool getMultiCoreRender() { return mSynth != nullptr && mSynth->getNumRenderThreads() > 1; }
+
+  void setMaxVoices(int value) {
+    if (mSynth != nullptr) mSynth->getParams().engine.maxVoices.store(value);
+  }
+  void setInterpolation(int value) {
+    if (mSynth != nullptr) mSynth->getParams().engine.interpolation.store(value);
+  }
+  int getInterpolation() { return mSynth != nullptr ? mSynth->getParams().engine.interpolation.load() : 0; }
+
+  int getMaxVoices() { return mSynth != nullptr ? mSynth->getParams().engine.maxVoices.load() : ParamEngine::DEFAULT_VOICES; }
+
+  // Same midi and parameters always render the same output
+  void setDeterministic(bool value) {
+    if (mSynth != nullptr) mSynth->getParams().engine.deterministic.store(value);
+  }
+  bool getDeterministic() { return mSynth != nullptr && mSynth->getParams().engine.deterministic.load(); }
+  void setSeed(juce::int64 value) {
+    if (mSynth != nullptr) mSynth->getParams().engine.seed.store(value);
+  }
+  juce::int64 getSeed() { return mSynth != nullptr ? mSynth->getParams().engine.seed.load() : 0; }
+
+  // 0 renders offline bounces like live, otherwise at the highest quality on every core (up to one render thread per voice) with
+  // 1 << (value - 1) times oversampling
+  void setOfflineQuality(int value) {
+    if (mSynth == nullptr) return;
+    mSynth->getParams().engine.offlineQuality.store(value > 0);
+    mSynth->getParams().engine.offlineOversampling.store(1 << juce::jmax(0, value - 1));
+  }
+  int getOfflineQuality() {
+    if (mSynth == nullptr || !mSynth->getParams().engine.offlineQuality.load()) return 0;
+    return 1 + static_cast<int>(std::log2(mSynth->getParams().engine.offlineOversampling.load()));
+  }
+
   // Creates a singleton
   PowerUserSettings(PowerUserSettings const&) = delete;
   void operator=(PowerUserSettings const&) = delete;
@@ -59,11 +96,17 @@ class SettingsComponent : public juce::Component {
   void resized() override;
 
   // height of setting component
-  int getHeight() { return 100; }
+  int getHeight() { return 280; }
 
 private:
   const int mDivideLineSize = 5;
   juce::TextButton mBtnAnimation;
   juce::TextButton mBtnResetParameters;
   juce::TextButton mBtnResourceUsage;
+  juce::TextButton mBtnMultiCoreRender;
+  juce::Slider mSliderMaxVoices;
+  juce::ComboBox mInterpolation;
+  juce::TextButton mBtnDeterministic;
+  juce::TextEditor mSeed;
+  juce::ComboBox mOfflineQuality;
 };
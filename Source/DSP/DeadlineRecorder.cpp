@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    DeadlineRecorder.cpp
+    Created: 19 Oct 2026 6:38:52am
+
+  ==============================================================================
+*/
+
+#include "DeadlineRecorder.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "Interpolation.h"
+#include "Parameters.h"
+
+DeadlineRecorder::DeadlineRecorder() : juce::Thread("gRainbow deadline log"), mLogFile(getDefaultLogFile()) {}
+
+DeadlineRecorder::~DeadlineRecorder() {
+  // Whatever was captured last still makes it to the log
+  stopThread(4000);
+  writePending();
+}
+
+juce::File DeadlineRecorder::getDefaultLogFile() {
+  return juce::FileLogger::getSystemLogFileFolder().getChildFile("gRainbow").getChildFile("deadline_misses.log");
+}
+
+void DeadlineRecorder::setLogFile(const juce::File& file) {
+  const juce::ScopedLock lock(mLogFileLock);
+  mLogFile = file;
+}
+
+juce::File DeadlineRecorder::getLogFile() const {
+  const juce::ScopedLock lock(mLogFileLock);
+  return mLogFile;
+}
+
+DeadlineRecorder::Snapshot* DeadlineRecorder::beginCapture() {
+  const juce::uint32 captured = mNumCaptured.load(std::memory_order_relaxed);
+  if (captured - mNumWritten.load(std::memory_order_acquire) >= NUM_SNAPSHOTS) {
+    mNumDropped.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  return &mSnapshots[captured % NUM_SNAPSHOTS];
+}
+
+void DeadlineRecorder::endCapture() { mNumCaptured.fetch_add(1, std::memory_order_release); }
+
+void DeadlineRecorder::run() {
+  while (!threadShouldExit()) {
+    wait(LOG_INTERVAL_MS);
+    writePending();
+  }
+}
+
+void DeadlineRecorder::writePending() {
+  const juce::uint32 captured = mNumCaptured.load(std::memory_order_acquire);
+  juce::uint32 written = mNumWritten.load(std::memory_order_relaxed);
+  const int dropped = mNumDropped.exchange(0, std::memory_order_relaxed);
+  if (captured == written && dropped == 0) return;
+
+  juce::String text;
+  for (; written != captured; ++written) {
+    text << describe(mSnapshots[written % NUM_SNAPSHOTS]);
+  }
+  // The slots can be reused as soon as they're turned into text
+  mNumWritten.store(written, std::memory_order_release);
+  if (dropped > 0) text << dropped << " more blocks went over without being recorded\n\n";
+
+  const juce::ScopedLock lock(mLogFileLock);
+  if (mLogFile == juce::File()) return;
+  if (mLogFile.getSize() > MAX_LOG_BYTES) mLogFile.moveFileTo(mLogFile.withFileExtension(".old"));
+  mLogFile.getParentDirectory().createDirectory();
+  mLogFile.appendText(text, false, false, "\n");
+}
+
+juce::String DeadlineRecorder::describe(const Snapshot& snapshot) {
+  const PerfCounters::BlockTimes& times = snapshot.times;
+  int slowestStage = 0;
+  for (int stage = 1; stage < PerfCounters::NUM_STAGES; ++stage) {
+    if (times.stageNs[stage] > times.stageNs[slowestStage]) slowestStage = stage;
+  }
+
+  juce::String text;
+  text << juce::Time(snapshot.timeMs).toString(true, true, true, true) << " took " << juce::String(times.blockNs * 1e-3, 1)
+       << " us of " << juce::String(times.deadlineNs * 1e-3, 1) << " us ("
+       << juce::String(100.0 * times.blockNs / juce::jmax(times.deadlineNs, static_cast<juce::int64>(1)), 0) << "%), mostly "
+       << PerfCounters::STAGE_NAMES[slowestStage] << "\n";
+  text << "  " << snapshot.blockSize << " samples at " << snapshot.sampleRate << " Hz, " << snapshot.renderThreads
+       << " render threads, " << snapshot.oversampling << "x oversampling, "
+       << Interpolation::QUALITY_NAMES[snapshot.interpolation] << " interpolation, governor at "
+       << juce::String(snapshot.governorScale, 2) << ", " << juce::String(snapshot.bpm, 1) << " bpm\n";
+  text << "  stages:";
+  for (int stage = 0; stage < PerfCounters::NUM_STAGES; ++stage) {
+    text << " " << PerfCounters::STAGE_NAMES[stage] << " " << juce::String(times.stageNs[stage] * 1e-3, 1) << " us";
+  }
+  text << "\n  " << snapshot.numVoices << " voices, " << snapshot.numGrains << " grains\n";
+
+  for (int v = 0; v < snapshot.numVoices; ++v) {
+    const VoiceState& voice = snapshot.voices[static_cast<size_t>(v)];
+    text << "  note " << juce::MidiMessage::getMidiNoteName(voice.midiNote, true, true, 4) << " vel "
+         << juce::String(voice.velocity, 2) << (voice.stolen ? " stolen" : (voice.releasing ? " releasing" : "")) << ":";
+    for (size_t g = 0; g < NUM_GENERATORS; ++g) {
+      const GeneratorState& gen = voice.generators[g];
+      text << " [gen " << static_cast<int>(g) + 1 << " " << gen.grains << " grains" << (gen.playing ? "" : " off")
+           << (gen.sync ? " sync" : "");
+      if (gen.filterType != Utils::FilterType::NO_FILTER) {
+        text << " " << FILTER_TYPE_NAMES[gen.filterType] << " (" << PARAM_TYPE_NAMES[gen.filterScope] << ")";
+      }
+      text << "]";
+    }
+    text << "\n";
+  }
+  return text + "\n";
+}
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    DeadlineRecorder.h
+    Created: 19 Oct 2026 6:38:52am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include "PerfCounters.h"
+#include "VoicePool.h"
+
+/**
+ * Keeps a record of blocks that came close to missing their deadline so overloads in real sessions can be looked into after the
+ * fact. The audio thread fills in a snapshot of what the synth was doing in a fixed ring of them, a background thread wakes up now
+ * and then and appends any new ones to a log file. Nothing on the audio thread side allocates, locks or wakes the thread up.
+ */
+class DeadlineRecorder : public juce::Thread {
+ public:
+  static constexpr int NUM_SNAPSHOTS = 16;  // Misses in between two log writes beyond this are only counted
+  static constexpr int LOG_INTERVAL_MS = 1000;
+  static constexpr juce::int64 MAX_LOG_BYTES = 1 << 20;  // The log is moved to a .old file once it grows past this
+
+  struct GeneratorState {
+    int grains;
+    bool playing;  // Enabled and not muted by a solo
+    bool sync;
+    juce::int8 filterType;   // Utils::FilterType
+    juce::int8 filterScope;  // ParamType of the filter it runs through
+  };
+
+  struct VoiceState {
+    int midiNote;
+    float velocity;
+    bool releasing;
+    bool stolen;
+    std::array<GeneratorState, NUM_GENERATORS> generators;
+  };
+
+  struct Snapshot {
+    juce::int64 timeMs;  // Wall clock, milliseconds since the epoch
+    double sampleRate;
+    int blockSize;
+    PerfCounters::BlockTimes times;
+    int renderThreads;
+    int oversampling;
+    int interpolation;
+    float governorScale;
+    double bpm;
+    int numGrains;
+    int numVoices;
+    std::array<VoiceState, VoicePool::MAX_VOICES> voices;
+  };
+
+  DeadlineRecorder();
+  ~DeadlineRecorder() override;
+
+  // Defaults to gRainbow/deadline_misses.log in the system's log folder
+  void setLogFile(const juce::File& file);
+  juce::File getLogFile() const;
+  static juce::File getDefaultLogFile();
+
+  // Audio thread only. Returns the snapshot to fill in, or nullptr if the ring is full, then endCapture() hands it to the logger.
+  Snapshot* beginCapture();
+  void endCapture();
+  // Misses that didn't fit in the ring since the last log write
+  int getNumDropped() const { return mNumDropped.load(std::memory_order_relaxed); }
+
+  void run() override;
+
+ private:
+  // Appends every snapshot the audio thread has finished
+  void writePending();
+  static juce::String describe(const Snapshot& snapshot);
+
+  std::array<Snapshot, NUM_SNAPSHOTS> mSnapshots;
+  // Only ever go up, the slot is the count modulo NUM_SNAPSHOTS
+  std::atomic<juce::uint32> mNumCaptured{0};
+  std::atomic<juce::uint32> mNumWritten{0};
+  std::atomic<int> mNumDropped{0};
+  juce::File mLogFile;
+  juce::CriticalSection mLogFileLock;  // Only between the logger thread and whoever sets the file, never the audio thread
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeadlineRecorder)
+};
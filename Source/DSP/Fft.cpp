@@ -26,10 +26,23 @@ Fft::~Fft() {}
 // notify when done
 void Fft::run() {
   if (mInputBuffer == nullptr) return;
+  computeSpectrum();
+  if (onProcessingComplete != nullptr) {
+    onProcessingComplete(mFftData);
+  }
+}
+
+void Fft::processSync(const juce::AudioBuffer<float>* audioBuffer) {
+  stopThread(4000);
+  mInputBuffer = audioBuffer;
+  if (mInputBuffer != nullptr) computeSpectrum();
+}
+
+void Fft::computeSpectrum() {
   clear(true);
-  // Runs with first channel
+  // Runs on all channels mixed down to mono
   const int numInputSamples = mInputBuffer->getNumSamples();
-  const float* pBuffer = mInputBuffer->getReadPointer(0);
+  const float* pBuffer = Utils::getMonoReadPointer(*mInputBuffer, mMonoBuffer);
   mFftFrame.resize(mWindowSize * 2, 0.0f);
   int curSample = 0;
   bool hasData = numInputSamples > mFftFrame.size();
@@ -65,14 +78,12 @@ void Fft::run() {
       hasData = false;
     }
   }
-
-  if (onProcessingComplete != nullptr) {
-    onProcessingComplete(mFftData);
-  }
 }
 
 void Fft::clear(bool clearData) {
   mFftFrame.clear();
+  mMonoBuffer.clear();
+  mMonoBuffer.shrink_to_fit();
   if (clearData) {
     // The FFT can take up a lot of memory, need to not just clear, but have STD deallocate it
     mFftData.clear();
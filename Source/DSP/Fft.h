@@ -27,6 +27,8 @@ class Fft : public juce::Thread {
   void clear(bool clearData);
 
   void process(const juce::AudioBuffer<float>* audioBuffer);
+  // Same as process() but runs on the calling thread and doesn't call onProcessingComplete, for offline tools
+  void processSync(const juce::AudioBuffer<float>* audioBuffer);
   const Utils::SpecBuffer& getSpectrum() { return mFftData; }
 
   std::function<void(Utils::SpecBuffer& spectrum)> onProcessingComplete = nullptr;
@@ -35,6 +37,9 @@ class Fft : public juce::Thread {
  private:
   // pointer to buffer to read from
   const juce::AudioBuffer<float>* mInputBuffer = nullptr;
+  std::vector<float> mMonoBuffer;  // mix of the input's channels when there is more than one
+
+  void computeSpectrum();
 
   // Used to show far along the run thread is
   void updateProgress(double progress);
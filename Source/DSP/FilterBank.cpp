@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    FilterBank.cpp
+    Created: 19 Oct 2026 12:31:40am
+
+  ==============================================================================
+*/
+
+#include "FilterBank.h"
+
+void FilterBank::prepare(const juce::dsp::ProcessSpec& spec) {
+  mSampleRate = spec.sampleRate;
+  mS1.assign(static_cast<size_t>(spec.numChannels) * NUM_LANES, 0.0f);
+  mS2.assign(static_cast<size_t>(spec.numChannels) * NUM_LANES, 0.0f);
+  // Lanes start out passing nothing until set
+  mTypes.fill(Utils::FilterType::NO_FILTER);
+  mCutoffs.fill(0.0f);
+  mResonances.fill(0.0f);
+  mG.fill(0.0f);
+  mR2.fill(0.0f);
+  mH.fill(0.0f);
+  mLowpass.fill(0.0f);
+  mBandpass.fill(0.0f);
+  mHighpass.fill(0.0f);
+}
+
+void FilterBank::reset() {
+  std::fill(mS1.begin(), mS1.end(), 0.0f);
+  std::fill(mS2.begin(), mS2.end(), 0.0f);
+}
+
+void FilterBank::setLane(int lane, Utils::FilterType type, float cutoff, float resonance) {
+  const size_t l = static_cast<size_t>(lane);
+  if (type == mTypes[l] && cutoff == mCutoffs[l] && resonance == mResonances[l]) return;
+  mTypes[l] = type;
+  mCutoffs[l] = cutoff;
+  mResonances[l] = resonance;
+
+  const double g = std::tan(juce::MathConstants<double>::pi * cutoff / mSampleRate);
+  const double r2 = 1.0 / resonance;
+  mG[l] = static_cast<float>(g);
+  mR2[l] = static_cast<float>(r2);
+  mH[l] = static_cast<float>(1.0 / (1.0 + r2 * g + g * g));
+  mLowpass[l] = (type == Utils::FilterType::LOWPASS) ? 1.0f : 0.0f;
+  mBandpass[l] = (type == Utils::FilterType::BANDPASS) ? 1.0f : 0.0f;
+  mHighpass[l] = (type == Utils::FilterType::HIGHPASS) ? 1.0f : 0.0f;
+}
+
+void FilterBank::processAndSum(const float* const* lanes, juce::AudioBuffer<float>& dest, int numChannels, int numSamples) {
+  for (int ch = 0; ch < numChannels; ++ch) {
+    // State is kept in locals for the block so the compiler knows nothing else writes to it
+    alignas(16) float s1[NUM_LANES];
+    alignas(16) float s2[NUM_LANES];
+    float* const stateS1 = mS1.data() + static_cast<size_t>(ch) * NUM_LANES;
+    float* const stateS2 = mS2.data() + static_cast<size_t>(ch) * NUM_LANES;
+    for (int l = 0; l < NUM_LANES; ++l) {
+      s1[l] = stateS1[l];
+      s2[l] = stateS2[l];
+    }
+
+    const float* x = lanes[ch];
+    float* out = dest.getWritePointer(ch);
+    for (int i = 0; i < numSamples; ++i) {
+      alignas(16) float y[NUM_LANES];
+      for (int l = 0; l < NUM_LANES; ++l) {
+        const float hp = mH[l] * (x[l] - s1[l] * (mG[l] + mR2[l]) - s2[l]);
+        const float bp = hp * mG[l] + s1[l];
+        s1[l] = hp * mG[l] + bp;
+        const float lp = bp * mG[l] + s2[l];
+        s2[l] = bp * mG[l] + lp;
+        y[l] = mLowpass[l] * lp + mBandpass[l] * bp + mHighpass[l] * hp;
+      }
+      out[i] += (y[0] + y[1]) + (y[2] + y[3]);
+      x += NUM_LANES;
+    }
+
+    for (int l = 0; l < NUM_LANES; ++l) {
+      stateS1[l] = s1[l];
+      stateS2[l] = s2[l];
+    }
+  }
+}
@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    FilterBank.h
+    Created: 19 Oct 2026 12:31:40am
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include "Utils/Utils.h"
+
+/**
+ * The state variable filters of every generator of a voice run side by side, one generator per lane. Samples are interleaved by
+ * lane so each step of the filter is the same operation on 4 adjacent floats, written as fixed size lane loops the compiler turns
+ * into a single vector instruction. Same topology preserving transform as juce::dsp::StateVariableTPTFilter.
+ */
+class FilterBank {
+ public:
+  static constexpr int NUM_LANES = 4;
+
+  // Allocates filter state for every channel, not real-time safe
+  void prepare(const juce::dsp::ProcessSpec& spec);
+  void reset();
+
+  // Sets the filter of a lane, the coefficients are only worked out again when something changed
+  void setLane(int lane, Utils::FilterType type, float cutoff, float resonance);
+
+  /**
+   * @brief Filters every lane and adds the sum of the lanes to dest
+   *
+   * @param lanes numChannels pointers to numSamples * NUM_LANES samples, lane l of sample i at [i * NUM_LANES + l]
+   */
+  void processAndSum(const float* const* lanes, juce::AudioBuffer<float>& dest, int numChannels, int numSamples);
+
+ private:
+  double mSampleRate = 44100.0;
+  // Parameters the coefficients were last computed for
+  std::array<Utils::FilterType, NUM_LANES> mTypes;
+  std::array<float, NUM_LANES> mCutoffs;
+  std::array<float, NUM_LANES> mResonances;
+  // Coefficients, see juce::dsp::StateVariableTPTFilter
+  alignas(16) std::array<float, NUM_LANES> mG;
+  alignas(16) std::array<float, NUM_LANES> mR2;
+  alignas(16) std::array<float, NUM_LANES> mH;
+  // How much of each output the lane passes on, picks the filter type without branching per lane
+  alignas(16) std::array<float, NUM_LANES> mLowpass;
+  alignas(16) std::array<float, NUM_LANES> mBandpass;
+  alignas(16) std::array<float, NUM_LANES> mHighpass;
+  // Integrator state, NUM_LANES per channel
+  std::vector<float> mS1;
+  std::vector<float> mS2;
+};
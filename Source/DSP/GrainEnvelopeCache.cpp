@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    GrainEnvelopeCache.cpp
+    Created: 18 Oct 2026 2:40:18pm
+
+  ==============================================================================
+*/
+
+#include "GrainEnvelopeCache.h"
+
+void GrainEnvelopeCache::prepare() {
+  mTables.assign(static_cast<size_t>(MAX_TABLES) * (TABLE_SIZE + 1), 0.0f);
+  mKeyToTable.assign(NUM_KEYS, INVALID_TABLE);
+  mTableKey.fill(-1);
+  mRefCount.fill(0);
+  mLastUsed.fill(0);
+  mUseCounter = 0;
+  mNumTables = 0;
+}
+
+int GrainEnvelopeCache::acquire(float shape, float tilt) {
+  if (mKeyToTable.empty()) return INVALID_TABLE;
+
+  const int shapeStep = juce::roundToInt(juce::jlimit(0.0f, 1.0f, shape) * QUANTIZE_STEPS);
+  const int tiltStep = juce::roundToInt(juce::jlimit(0.0f, 1.0f, tilt) * QUANTIZE_STEPS);
+  const int key = (shapeStep * (QUANTIZE_STEPS + 1)) + tiltStep;
+
+  int table = mKeyToTable[key];
+  if (table == INVALID_TABLE) {
+    if (mNumTables < MAX_TABLES) {
+      table = mNumTables++;
+    } else {
+      // Evict the least recently used table no grain is using
+      for (int i = 0; i < MAX_TABLES; ++i) {
+        if (mRefCount[i] == 0 && (table == INVALID_TABLE || mLastUsed[i] < mLastUsed[table])) {
+          table = i;
+        }
+      }
+      if (table == INVALID_TABLE) {
+        // Every table is in use (only from sweeping shape/tilt quickly), the closest envelope is good enough until grains expire
+        table = findNearestTable(key);
+        mRefCount[table]++;
+        mLastUsed[table] = ++mUseCounter;
+        return table;
+      }
+      mKeyToTable[mTableKey[table]] = INVALID_TABLE;
+    }
+
+    float* data = mTables.data() + (static_cast<size_t>(table) * (TABLE_SIZE + 1));
+    Utils::fillGrainEnvelope(data, TABLE_SIZE, static_cast<float>(shapeStep) / QUANTIZE_STEPS,
+                             static_cast<float>(tiltStep) / QUANTIZE_STEPS);
+    data[TABLE_SIZE] = data[TABLE_SIZE - 1];
+    mTableKey[table] = key;
+    mKeyToTable[key] = table;
+  }
+
+  mRefCount[table]++;
+  mLastUsed[table] = ++mUseCounter;
+  return table;
+}
+
+void GrainEnvelopeCache::release(int table) {
+  jassert(table >= 0 && table < mNumTables && mRefCount[table] > 0);
+  mRefCount[table]--;
+}
+
+int GrainEnvelopeCache::findNearestTable(int key) const {
+  const int shapeStep = key / (QUANTIZE_STEPS + 1);
+  const int tiltStep = key % (QUANTIZE_STEPS + 1);
+  int nearest = 0;
+  int nearestDistance = std::numeric_limits<int>::max();
+  for (int i = 0; i < mNumTables; ++i) {
+    const int distance =
+        std::abs((mTableKey[i] / (QUANTIZE_STEPS + 1)) - shapeStep) + std::abs((mTableKey[i] % (QUANTIZE_STEPS + 1)) - tiltStep);
+    if (distance < nearestDistance) {
+      nearest = i;
+      nearestDistance = distance;
+    }
+  }
+  return nearest;
+}
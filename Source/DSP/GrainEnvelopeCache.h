@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    GrainEnvelopeCache.h
+    Created: 18 Oct 2026 2:40:18pm
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <juce_core/juce_core.h>
+#include "Utils/Utils.h"
+
+/**
+ * Interned grain envelope tables keyed by (shape, tilt), quantized to the 0.01 steps the UI sliders use.
+ * Each distinct envelope is built once at a high resolution and shared by every grain using it. Grains hold a reference to a table
+ * by its index so it is never rebuilt while in use. All storage is allocated in prepare(), so acquiring and releasing are real-time
+ * safe, but the class is not thread safe and is only used from the audio thread.
+ */
+class GrainEnvelopeCache {
+ public:
+  static constexpr int TABLE_SIZE = 1024;
+  static constexpr int MAX_TABLES = 128;
+  static constexpr int QUANTIZE_STEPS = 100;
+  static constexpr int INVALID_TABLE = -1;
+
+  // Allocates all tables and forgets any built ones. Not real-time safe.
+  void prepare();
+
+  // Returns the index of the table for the envelope, building it if not already cached. Every call needs a matching release().
+  int acquire(float shape, float tilt);
+  void release(int table);
+
+  // Each table holds TABLE_SIZE + 1 points, the last repeated so linear interpolation can always read the next point
+  const float* getTable(int table) const { return mTables.data() + (static_cast<size_t>(table) * (TABLE_SIZE + 1)); }
+  int getNumTables() const { return mNumTables; }
+
+ private:
+  static constexpr int NUM_KEYS = (QUANTIZE_STEPS + 1) * (QUANTIZE_STEPS + 1);
+
+  int findNearestTable(int key) const;
+
+  std::vector<float> mTables;
+  std::vector<int> mKeyToTable;  // INVALID_TABLE if the key isn't built
+  std::array<int, MAX_TABLES> mTableKey;
+  std::array<int, MAX_TABLES> mRefCount;
+  std::array<juce::uint32, MAX_TABLES> mLastUsed;  // for evicting the least recently used unreferenced table
+  juce::uint32 mUseCounter = 0;
+  int mNumTables = 0;
+};
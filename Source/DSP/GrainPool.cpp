@@ -0,0 +1,149 @@
+/*
+  ==============================================================================
+
+    GrainPool.cpp
+    Created: 18 Oct 2026 10:12:04am
+
+  ==============================================================================
+*/
+
+#include "GrainPool.h"
+
+void GrainPool::prepare(int capacity) {
+  mCapacity = capacity;
+  mPhase.assign(capacity, 0.0);
+  mIncrement.assign(capacity, 0.0f);
+  mTrigTs.assign(capacity, 0);
+  mDuration.assign(capacity, 0);
+  mPanGainL.assign(capacity, 0.0f);
+  mPanGainR.assign(capacity, 0.0f);
+  mEnv.assign(capacity, nullptr);
+  mEnvTable.assign(capacity, GrainEnvelopeCache::INVALID_TABLE);
+  mEnvelopes.prepare();
+  mFreeList.resize(capacity);
+  for (int i = 0; i < capacity; ++i) {
+    // Lowest ids are handed out first
+    mFreeList[i] = capacity - 1 - i;
+  }
+  mNumFree = capacity;
+}
+
+int GrainPool::add(float shape, float tilt, int duration, float pbRate, int startPos, long trigTs, float pan) {
+  if (mNumFree == 0) return INVALID_GRAIN;
+  const int envTable = mEnvelopes.acquire(shape, tilt);
+  if (envTable == GrainEnvelopeCache::INVALID_TABLE) return INVALID_GRAIN;
+  const int id = mFreeList[--mNumFree];
+
+  mPhase[id] = static_cast<double>(juce::jmax(0, startPos));
+  mIncrement[id] = pbRate;
+  mTrigTs[id] = trigTs;
+  mDuration[id] = duration;
+  // Panning is fixed for the life of the grain, so only compute the gains once
+  const float angle = (pan + 1.0f) * juce::MathConstants<float>::pi / 4.0f;
+  mPanGainL[id] = std::abs(std::cos(angle));
+  mPanGainR[id] = std::abs(std::cos(angle + juce::MathConstants<float>::halfPi));
+  mEnvTable[id] = envTable;
+  mEnv[id] = mEnvelopes.getTable(envTable);
+  return id;
+}
+
+void GrainPool::remove(int id) {
+  jassert(id >= 0 && id < mCapacity && mNumFree < mCapacity);
+  mEnvelopes.release(mEnvTable[id]);
+  mFreeList[mNumFree++] = id;
+}
+
+void GrainPool::process(int id, const SourcePyramid& source, juce::AudioBuffer<float>& outBuffer, float* scratch, int startSample,
+                        int numSamples, long blockTs, Interpolation::Quality quality) const {
+  const int numFullSamples = source.getNumSamples(0);
+  if (numFullSamples < 2) return;
+
+  const long trigTs = mTrigTs[id];
+  const int duration = mDuration[id];
+  // Transposing up reads a decimated level instead, which keeps the increment near 1 and has nothing left to alias. The phase is
+  // kept in full rate samples so a grain can move between levels as they finish building.
+  const int level = source.getLevel(mIncrement[id]);
+  const double levelScale = static_cast<double>(1 << level);
+  const float pbRate = mIncrement[id] / static_cast<float>(levelScale);
+  const int numSourceSamples = source.getNumSamples(level);
+  if (numSourceSamples < 2) return;
+
+  // Clamp to the part of the block where the grain is alive
+  const int begin = static_cast<int>(juce::jlimit(0L, static_cast<long>(numSamples), trigTs - blockTs));
+  const int end = static_cast<int>(juce::jlimit(0L, static_cast<long>(numSamples), trigTs + duration - blockTs));
+  const int count = end - begin;
+  if (count <= 0) return;
+
+  // Stereo sources are read as a pair so the position math is only done once for both channels
+  const int numSourceChannels = source.getNumChannels();
+  const float* fileBufs[SourcePyramid::MAX_CHANNELS] = {source.getReadPointer(level, 0),
+                                                        source.getReadPointer(level, numSourceChannels - 1)};
+  float* grainBufs[SourcePyramid::MAX_CHANNELS] = {scratch, scratch + numSamples};
+  const long elapsed = blockTs + begin - trigTs;
+  const int tapsBefore = Interpolation::getTapsBefore(quality);
+  const int tapsAfter = Interpolation::getTapsAfter(quality);
+
+  // Read position of the first sample. Everything after is a straight line until the interpolation taps pass either end of the
+  // buffer, so the block is split into segments there instead of wrapping each sample.
+  double pos = std::fmod(mPhase[id] + static_cast<double>(elapsed) * mIncrement[id], static_cast<double>(numFullSamples));
+  pos = std::fmod(pos / levelScale, static_cast<double>(numSourceSamples));
+  int i = 0;
+  while (i < count) {
+    const int lowSample = static_cast<int>(pos);
+    // Samples that can be read before the last tap passes the last sample
+    const int segment = (lowSample < tapsBefore)
+                            ? 0
+                            : juce::jmin(count - i, static_cast<int>((numSourceSamples - tapsAfter - pos) / pbRate));
+    if (segment <= 0) {
+      // Interpolating across the start or end of the buffer
+      for (int ch = 0; ch < numSourceChannels; ++ch) {
+        grainBufs[ch][i] = Interpolation::processWrapped(quality, fileBufs[ch], numSourceSamples, pos, pbRate);
+      }
+      i++;
+      pos += pbRate;
+    } else {
+      const float offset = static_cast<float>(pos - lowSample);
+      if (numSourceChannels == 1) {
+        Interpolation::process(quality, fileBufs[0] + lowSample, offset, pbRate, grainBufs[0] + i, segment);
+      } else {
+        const float* src[] = {fileBufs[0] + lowSample, fileBufs[1] + lowSample};
+        float* dest[] = {grainBufs[0] + i, grainBufs[1] + i};
+        Interpolation::processStereo(quality, src, offset, pbRate, dest, segment);
+      }
+      i += segment;
+      pos += static_cast<double>(segment) * pbRate;
+    }
+    if (pos >= numSourceSamples) pos -= numSourceSamples;
+  }
+
+  // Grain envelope, linearly interpolated. Elapsed time is always within [0, duration) and the table has a guard point at the end,
+  // so reading the next point never leaves the table
+  const float* env = mEnv[id];
+  const float envScale = static_cast<float>(GrainEnvelopeCache::TABLE_SIZE - 1) / static_cast<float>(duration);
+  const float envStart = static_cast<float>(elapsed) * envScale;
+  for (int j = 0; j < count; ++j) {
+    const float envPos = envStart + static_cast<float>(j) * envScale;
+    const int envIdx = static_cast<int>(envPos);
+    const float rem = envPos - static_cast<float>(envIdx);
+    const float gain = env[envIdx] + rem * (env[envIdx + 1] - env[envIdx]);
+    for (int ch = 0; ch < numSourceChannels; ++ch) {
+      grainBufs[ch][j] *= gain;
+    }
+  }
+
+  // Panning has no meaning for a mono output, so it is left at unity gain there and a stereo source is summed to it. Otherwise each
+  // source channel goes to its own side and panning works as a balance.
+  const int numChannels = outBuffer.getNumChannels();
+  if (numChannels == 1) {
+    const float gain = 1.0f / static_cast<float>(numSourceChannels);
+    for (int ch = 0; ch < numSourceChannels; ++ch) {
+      juce::FloatVectorOperations::addWithMultiply(outBuffer.getWritePointer(0, startSample + begin), grainBufs[ch], gain, count);
+    }
+    return;
+  }
+  for (int ch = 0; ch < numChannels; ++ch) {
+    const float panGain = (ch == 0) ? mPanGainL[id] : mPanGainR[id];
+    const float* grainBuf = grainBufs[juce::jmin(ch, numSourceChannels - 1)];
+    juce::FloatVectorOperations::addWithMultiply(outBuffer.getWritePointer(ch, startSample + begin), grainBuf, panGain, count);
+  }
+}
@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    GrainPool.h
+    Created: 18 Oct 2026 10:12:04am
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "Utils/Utils.h"
+#include "GrainEnvelopeCache.h"
+#include "Interpolation.h"
+#include "SourcePyramid.h"
+
+/**
+ * Fixed capacity storage for every grain of the synth, laid out as a structure of arrays so the fields read while rendering are
+ * contiguous. All memory is allocated in prepare(), after that grains are recycled through a free list so triggering and retiring
+ * them from the audio thread never touches the allocator.
+ */
+class GrainPool {
+ public:
+  static constexpr int INVALID_GRAIN = -1;
+
+  // Allocates room for capacity grains and drops any active ones. Not real-time safe.
+  void prepare(int capacity);
+
+  /**
+   * @brief Takes a grain from the free list
+   *
+   * @param duration Grain duration in samples
+   * @param pbRate Playback rate (1.0 being regular speed)
+   * @param startPos Start position in file to play from in samples
+   * @param trigTs Timestamp when grain was triggered in samples
+   * @return the grain id or INVALID_GRAIN if the pool is empty
+   */
+  int add(float shape, float tilt, int duration, float pbRate, int startPos, long trigTs, float pan);
+  // Gives the grain back to the free list
+  void remove(int id);
+
+  bool isExpired(int id, long ts) const { return ts > mTrigTs[id] + mDuration[id]; }
+  int getNumActive() const { return mCapacity - mNumFree; }
+  int getCapacity() const { return mCapacity; }
+
+  /**
+   * @brief Renders a grain for the block of timestamps [blockTs, blockTs + numSamples) and adds it to every channel of outBuffer,
+   * starting at startSample. Only the part of the block the grain is alive for is touched.
+   *
+   * @param source Source buffer and its band-limited levels, the level is picked from the grain's playback rate
+   * @param scratch Temp memory for the grain signal, needs to hold numSamples floats for each of the source's channels
+   * @param quality How the source is interpolated between samples
+   */
+  void process(int id, const SourcePyramid& source, juce::AudioBuffer<float>& outBuffer, float* scratch, int startSample,
+               int numSamples, long blockTs, Interpolation::Quality quality) const;
+
+ private:
+  int mCapacity = 0;
+  // Hot fields, read every block a grain is rendered
+  std::vector<double> mPhase;      // read position in the file at trigTs
+  std::vector<float> mIncrement;   // read position increment per sample (playback rate)
+  std::vector<long> mTrigTs;       // timestamp when grain was triggered in samples
+  std::vector<int> mDuration;      // grain duration in samples
+  std::vector<float> mPanGainL;    // left channel gain, computed once at trigger
+  std::vector<float> mPanGainR;    // right channel gain, computed once at trigger
+  std::vector<const float*> mEnv;  // shared envelope table of GrainEnvelopeCache::TABLE_SIZE
+  // Cold fields
+  std::vector<int> mEnvTable;  // index of the envelope table the grain holds a reference to
+  GrainEnvelopeCache mEnvelopes;
+  // Stack of unused grain ids
+  std::vector<int> mFreeList;
+  int mNumFree = 0;
+};
+
+// The ids of the grains a single generator has active, in no particular order
+struct GrainList {
+  static constexpr int MAX_GRAINS = 20;  // Max grains active at once
+
+  std::array<int, MAX_GRAINS> ids;
+  int size = 0;
+
+  bool isFull() const { return size >= MAX_GRAINS; }
+  bool isEmpty() const { return size == 0; }
+  void add(int id) { ids[size++] = id; }
+  // Order isn't kept, the last id takes the removed one's place
+  void removeAt(int index) { ids[index] = ids[--size]; }
+  const int* begin() const { return ids.data(); }
+  const int* end() const { return ids.data() + size; }
+};
@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    GrainScheduler.cpp
+    Created: 18 Oct 2026 6:41:17pm
+
+  ==============================================================================
+*/
+
+#include "GrainScheduler.h"
+
+bool GrainScheduler::push(double ts, int voice, int gen) {
+  if (mSize >= CAPACITY) {
+    jassertfalse;
+    return false;
+  }
+  mHeap[static_cast<size_t>(mSize)] = {ts, voice, gen};
+  siftUp(mSize++);
+  return true;
+}
+
+void GrainScheduler::pop() {
+  jassert(mSize > 0);
+  mHeap[0] = mHeap[static_cast<size_t>(--mSize)];
+  siftDown(0);
+}
+
+void GrainScheduler::removeVoice(int voice) {
+  int kept = 0;
+  for (int i = 0; i < mSize; ++i) {
+    if (mHeap[static_cast<size_t>(i)].voice != voice) mHeap[static_cast<size_t>(kept++)] = mHeap[static_cast<size_t>(i)];
+  }
+  if (kept == mSize) return;
+  mSize = kept;
+  // Rebuild the heap, only happens when a voice finishes so not worth being clever
+  for (int i = mSize / 2 - 1; i >= 0; --i) {
+    siftDown(i);
+  }
+}
+
+void GrainScheduler::siftUp(int index) {
+  while (index > 0) {
+    const int parent = (index - 1) / 2;
+    if (!isEarlier(mHeap[static_cast<size_t>(index)], mHeap[static_cast<size_t>(parent)])) break;
+    std::swap(mHeap[static_cast<size_t>(index)], mHeap[static_cast<size_t>(parent)]);
+    index = parent;
+  }
+}
+
+void GrainScheduler::siftDown(int index) {
+  while (true) {
+    const int left = index * 2 + 1;
+    const int right = left + 1;
+    int earliest = index;
+    if (left < mSize && isEarlier(mHeap[static_cast<size_t>(left)], mHeap[static_cast<size_t>(earliest)])) earliest = left;
+    if (right < mSize && isEarlier(mHeap[static_cast<size_t>(right)], mHeap[static_cast<size_t>(earliest)])) earliest = right;
+    if (earliest == index) break;
+    std::swap(mHeap[static_cast<size_t>(index)], mHeap[static_cast<size_t>(earliest)]);
+    index = earliest;
+  }
+}
@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+
+    GrainScheduler.h
+    Created: 18 Oct 2026 6:41:17pm
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <juce_core/juce_core.h>
+#include "Parameters.h"
+#include "VoicePool.h"
+
+/**
+ * Keeps the next grain trigger timestamp of every generator of every voice in a min-heap, so the synth can pop exactly the triggers
+ * that fall inside a block in time order instead of polling every generator once per block. Storage is fixed, nothing allocates.
+ */
+class GrainScheduler {
+ public:
+  struct Trigger {
+    double ts;  // Timestamp in samples the next grain should start at
+    int voice;  // VoicePool index
+    int gen;
+  };
+
+  void clear() { mSize = 0; }
+  bool isEmpty() const { return mSize == 0; }
+  int size() const { return mSize; }
+
+  // Returns false if the scheduler is full, which can only happen if a voice was scheduled twice
+  bool push(double ts, int voice, int gen);
+  const Trigger& top() const { return mHeap[0]; }
+  void pop();
+  // Drops all the triggers of a voice, used when it is released
+  void removeVoice(int voice);
+
+ private:
+  static constexpr int CAPACITY = VoicePool::MAX_VOICES * NUM_GENERATORS;
+
+  // Ties are broken by voice and generator so the order grains are started in is repeatable
+  static bool isEarlier(const Trigger& a, const Trigger& b) {
+    if (a.ts != b.ts) return a.ts < b.ts;
+    if (a.voice != b.voice) return a.voice < b.voice;
+    return a.gen < b.gen;
+  }
+  void siftUp(int index);
+  void siftDown(int index);
+
+  std::array<Trigger, CAPACITY> mHeap;
+  int mSize = 0;
+};
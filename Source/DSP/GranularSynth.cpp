@@ -14,6 +14,7 @@
 #include "Preset.h"
 #include "PluginEditor.h"
 #include "Components/Settings.h"
+#include "Utils/RtCheck.h"
 
 GranularSynth::GranularSynth()
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -29,15 +30,18 @@ GranularSynth::GranularSynth()
       ,
       // only care about tracking the processing of the DSP, not the spectrogram
       mFft(FFT_SIZE, HOP_SIZE, 0, 0),
-      mPitchDetector(0.01, 1.0) {
+      mPitchDetector(0.01, 1.0),
+      mSourcePyramid(mAudioBuffer) {
   mParameters.note.addParams(*this);
   mParameters.global.addParams(*this);
+  // Lets the audio thread know when the resolved generator parameters need to be rebuilt
+  for (juce::AudioProcessorParameter* param : getParameters()) {
+    param->addListener(&mParameters);
+  }
 
   mTotalSamps = 0;
   mProcessedSpecs.fill(nullptr);
 
-  mKeyboardState.addListener(this);
-
   mFormatManager.registerBasicFormats();
 
   mFft.onProcessingComplete = [this](Utils::SpecBuffer& spectrum) {
@@ -62,7 +66,11 @@ GranularSynth::GranularSynth()
   resetParameters();
 }
 
-GranularSynth::~GranularSynth() {}
+GranularSynth::~GranularSynth() {
+  for (juce::AudioProcessorParameter* param : getParameters()) {
+    param->removeListener(&mParameters);
+  }
+}
 
 //==============================================================================
 const juce::String GranularSynth::getName() const { return JucePlugin_Name; }
@@ -111,7 +119,7 @@ void GranularSynth::changeProgramName(int, const juce::String&) {}
 
 //==============================================================================
 void GranularSynth::prepareToPlay(double sampleRate, int samplesPerBlock) {
-    if (mNeedsResample) {
+  if (mNeedsResample) {
     // File loaded from state but couldn't resample and trim until now
     // Make a temporary buffer copy for resampling
     juce::AudioSampleBuffer inputBuffer = mInputBuffer;
@@ -123,6 +131,7 @@ void GranularSynth::prepareToPlay(double sampleRate, int samplesPerBlock) {
     juce::int64 start = static_cast<juce::int64>(sampleLength * (mParameters.ui.trimRange.getStart() / secondLength));
     juce::int64 end = static_cast<juce::int64>(sampleLength * (mParameters.ui.trimRange.getEnd() / secondLength));
     trimAudioBuffer(mInputBuffer, mAudioBuffer, juce::Range<juce::int64>(start, end));
+    mSourcePyramid.build();
     mInputBuffer.clear();
     mParameters.ui.loadingProgress = RESET_LOADING_PROGRESS;
     mNeedsResample = false;
@@ -130,17 +139,50 @@ void GranularSynth::prepareToPlay(double sampleRate, int samplesPerBlock) {
 
   mSampleRate = sampleRate;
 
-  const juce::dsp::ProcessSpec filtConfig = {sampleRate, (juce::uint32)samplesPerBlock, (unsigned int)getTotalNumOutputChannels()};
-  mParameters.global.filter.prepare(filtConfig);
-  for (auto&& note : mParameters.note.notes) {
-    note->filter.prepare(filtConfig);
-    for (auto&& gen : note->generators) {
-      gen->filter.prepare(filtConfig);
-      gen->sampleRate = sampleRate;
-    }
+  // Bouncing offline can render the grains and filters oversampled, the whole voice engine then runs at the higher rate and only
+  // the final mix is brought back down
+  mOversampling = isOfflineQuality() ? juce::jlimit(1, MAX_OVERSAMPLING, mParameters.engine.offlineOversampling.load()) : 1;
+  mRenderRate = sampleRate * mOversampling;
+  const int renderBlockSize = samplesPerBlock * mOversampling;
+  const int numOutputChannels = getTotalNumOutputChannels();
+  if (mOversampling > 1) {
+    mOversampler = std::make_unique<juce::dsp::Oversampling<float>>(
+        static_cast<size_t>(numOutputChannels), static_cast<size_t>(std::log2(mOversampling)),
+        juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple, true);
+    mOversampler->initProcessing(static_cast<size_t>(samplesPerBlock));
+    setLatencySamples(juce::roundToInt(mOversampler->getLatencyInSamples()));
+  } else {
+    mOversampler.reset();
+    setLatencySamples(0);
   }
+
+  const juce::dsp::ProcessSpec filtConfig = {mRenderRate, (juce::uint32)renderBlockSize, (unsigned int)numOutputChannels};
+  mVoices.prepare(filtConfig);
+  mGlobalFilter.prepare(filtConfig);
   mMeterSource.resize(getTotalNumOutputChannels(), sampleRate * 0.1 / samplesPerBlock);
+  mLoadGovernor.prepare(sampleRate, samplesPerBlock);
+  mTransport.prepare(mRenderRate);
+
+  // Any grain ids held by notes are from the old pool
+  mGrainPool.prepare(GRAIN_POOL_SIZE);
+  mPerf.prepare(GRAIN_POOL_SIZE);
+  for (int voiceIdx = 0; voiceIdx < VoicePool::MAX_VOICES; ++voiceIdx) {
+    if (GrainNote* gNote = mVoices.getActive(voiceIdx)) {
+      for (GrainList& grains : gNote->genGrains) {
+        grains.size = 0;
+      }
+    }
+  }
+
+  // Hosts prepare again after switching between live and offline, which is when the render threads switch over too
+  if (mRenderPool.getNumThreads() != getTargetRenderThreads()) mRenderPool.setNumWorkers(getTargetRenderThreads() - 1);
+
+  // Scratch space for rendering the grains of a generator a block at a time
+  mGlobalBuffer.setSize(numOutputChannels, renderBlockSize);
+  prepareRenderScratch();
   mReferenceTone.prepareToPlay(samplesPerBlock, sampleRate);
+  mUiMidiOut.ensureSize(UI_MIDI_OUT_BYTES);
+  if (!mDeadlineRecorder.isThreadRunning()) mDeadlineRecorder.startThread(juce::Thread::Priority::low);
 }
 
 void GranularSynth::releaseResources() {
@@ -170,12 +212,60 @@ bool GranularSynth::isBusesLayoutSupported(const BusesLayout& layouts) const {
 #endif
 
 void GranularSynth::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
+  Utils::RtCheck::ScopedAudioThread rtCheck;
   juce::ScopedNoDenormals noDenormals;
   auto totalNumInputChannels = getTotalNumInputChannels();
   auto totalNumOutputChannels = getTotalNumOutputChannels();
   const int bufferNumSample = buffer.getNumSamples();
-
-  mKeyboardState.processNextMidiBuffer(midiMessages, 0, bufferNumSample, true);
+  PerfCounters::StageTimer blockTimer;
+  blockTimer.tick();
+  mPerf.beginBlock(bufferNumSample, mSampleRate);
+  PerfCounters::StageTimer stageTimer;
+  juce::AudioProcessLoadMeasurer::ScopedTimer loadTimer(mLoadGovernor.getLoadMeasurer(), bufferNumSample);
+  // The governor reacts to how long blocks take, which is never the same twice
+  const bool deterministic = mParameters.engine.deterministic.load();
+  // Nor does it need to do anything when there is no deadline
+  const bool offlineQuality = isOfflineQuality();
+  mLoadGovernor.update(mParameters.engine.loadThreshold.load(),
+                       mParameters.engine.loadGovernor.load() && !deterministic && !offlineQuality);
+  mSourcePyramid.setDeterministic(deterministic);
+  // The only time the host's playhead is asked for anything, grains triggered this block all use this snapshot
+  mTransport.update(getPlayHead(), mTotalSamps, bufferNumSample * mOversampling);
+  const int maxQuality = static_cast<int>(Interpolation::Quality::COUNT) - 1;
+  mInterpolation = offlineQuality ? Interpolation::Quality::SINC
+                                  : static_cast<Interpolation::Quality>(
+                                        juce::jlimit(0, maxQuality, mParameters.engine.interpolation.load()));
+
+  // Only walks the parameter hierarchy again if a parameter changed since the last block
+  mParameters.resolveGenerators();
+
+  // Notes from the on-screen keyboard start at the top of the block and are played straight from the queue
+  stageTimer.tick();
+  mUiMidiOut.clear();
+  Utils::NoteEvent uiEvent;
+  while (mUiNoteEvents.pop(uiEvent)) {
+    const juce::MidiMessage message = uiEvent.isNoteOn
+                                          ? juce::MidiMessage::noteOn(UI_MIDI_CHANNEL, uiEvent.midiNote, uiEvent.velocity)
+                                          : juce::MidiMessage::noteOff(UI_MIDI_CHANNEL, uiEvent.midiNote);
+    handleMidiMessage(message, mTotalSamps);
+    mUiMidiOut.addEvent(message, 0);
+  }
+  // Host midi lands on the sample it was sent for, so note timing doesn't depend on the buffer size
+  for (const juce::MidiMessageMetadata metadata : midiMessages) {
+    handleMidiMessage(metadata.getMessage(), mTotalSamps + static_cast<long>(metadata.samplePosition) * mOversampling);
+  }
+  // The on-screen keyboard's notes go out with the host's midi. Adding them to the host's buffer could grow it, so the host's
+  // events are added to the preallocated one instead and the two are swapped. What comes back is the host's storage, which already
+  // held its own midi.
+  if (!mUiMidiOut.isEmpty()) {
+    mUiMidiOut.addEvents(midiMessages, 0, -1, 0);
+    midiMessages.swapWith(mUiMidiOut);
+  }
+  if (mHeldNotesChanged) {
+    mHeldNotesSnapshot.write(mHeldNotes);
+    mHeldNotesChanged = false;
+  }
+  mPerf.lap(PerfCounters::Stage::MIDI, stageTimer);
 
   // In case we have more outputs than inputs, this code clears any output
   // channels that didn't contain input data, (because these aren't
@@ -207,45 +297,64 @@ void GranularSynth::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuf
     mParameters.ui.trimPlaybackSample += numSample;
   }
 
-  // Add contributions from each note
-  auto bufferChannels = buffer.getArrayOfWritePointers();
-  for (int i = 0; i < bufferNumSample; ++i) {
-    // Don't use a for(auto x : mActiveNotes) loop here as mActiveNotes can be added outside this function. If it is partially added
-    // it might to use it and the undefined data will cause a crash eventually
-    const int activeNoteSize = mActiveNotes.size();
-    for (int noteIndex = 0; noteIndex < activeNoteSize; noteIndex++) {
-      GrainNote* gNote = mActiveNotes[noteIndex];
-
-      // Add contributions from the grains in this generator
-
-      for (size_t genIdx = 0; genIdx < NUM_GENERATORS; ++genIdx) {
-        ParamGenerator* paramGenerator = mParameters.note.notes[gNote->pitchClass]->generators[genIdx].get();
-        const float gain = mParameters.getFloatParam(paramGenerator, ParamCommon::Type::GAIN);
-        const float attack = mParameters.getFloatParam(paramGenerator, ParamCommon::Type::ATTACK);
-        const float decay = mParameters.getFloatParam(paramGenerator, ParamCommon::Type::DECAY);
-        const float sustain = mParameters.getFloatParam(paramGenerator, ParamCommon::Type::SUSTAIN);
-        const float release = mParameters.getFloatParam(paramGenerator, ParamCommon::Type::RELEASE);
-        const float grainGain =
-            gNote->genAmpEnvs[genIdx].getAmplitude(mTotalSamps, attack * mSampleRate, decay * mSampleRate, sustain,
-                                                  release * mSampleRate) * gain;
-        for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-          float genSample = 0.0f;
-          for (Grain& grain : gNote->genGrains[genIdx]) {
-            genSample += grain.process(ch / (float)(buffer.getNumChannels() - 1), mAudioBuffer, grainGain, mTotalSamps);
-          }
-          // Process filter and optionally use for output
-          const float filterOutput = mParameters.getFilterOutput(paramGenerator, ch, genSample);
-          // If filter type isn't "none", use its output
-          const int filtType = mParameters.getChoiceParam(paramGenerator, ParamCommon::Type::FILT_TYPE);
-          if (filtType != Utils::FilterType::NO_FILTER) {
-            genSample = filterOutput;
-          }
+  // Add contributions from each note. Grains are rendered a whole sub-block at a time, the sub-blocks are only there in case the host
+  // gives a larger block than what was promised in prepareToPlay. When oversampling the voices render renderSize samples for each
+  // subBlockSize samples of output. The output sub-block is brought up to the render rate first, the voices are added to that and
+  // the whole thing is brought back down in place.
+  const int maxSubBlockSize = mGlobalBuffer.getNumSamples() / mOversampling;
+  const int numChannels = juce::jmin(buffer.getNumChannels(), mGlobalBuffer.getNumChannels());
+  for (int subBlockStart = 0; maxSubBlockSize > 0 && subBlockStart < bufferNumSample; subBlockStart += maxSubBlockSize) {
+    const int subBlockSize = juce::jmin(maxSubBlockSize, bufferNumSample - subBlockStart);
+    const int renderSize = subBlockSize * mOversampling;
+    if (mOversampler != nullptr) upsampleOutput(buffer, subBlockStart, numChannels, subBlockSize);
+    juce::AudioBuffer<float>& renderBuffer = (mOversampler != nullptr) ? mOversampledBuffer : buffer;
+    const int renderStart = (mOversampler != nullptr) ? 0 : subBlockStart;
+    // Grains triggered part way through start rendering at their own offset in the sub-block
+    stageTimer.tick();
+    triggerGrains(renderSize);
+    mPerf.lap(PerfCounters::Stage::SCHEDULING, stageTimer);
+
+    // Each voice renders into its own buffers so they can be rendered on any thread in any order
+    RenderJobs jobs = {this, {}, 0, numChannels, renderSize};
+    for (int voiceIdx = 0; voiceIdx < VoicePool::MAX_VOICES; ++voiceIdx) {
+      if (GrainNote* gNote = mVoices.getActive(voiceIdx)) jobs.voices[static_cast<size_t>(jobs.numVoices++)] = gNote;
+    }
+    if (mRenderPool.getNumWorkers() > 0 && jobs.numVoices >= MIN_PARALLEL_VOICES) {
+      mRenderPool.run(jobs.numVoices, renderVoiceJob, &jobs);
+    } else {
+      for (int i = 0; i < jobs.numVoices; ++i) {
+        renderVoice(*jobs.voices[static_cast<size_t>(i)], mRenderScratch[0], numChannels, renderSize);
+      }
+    }
 
-          bufferChannels[ch][i] += genSample;
-        }
+    // Always summed in voice order so the output doesn't depend on which thread finished first
+    // Generators using the global filter params are summed and filtered once after all the voices
+    stageTimer.tick();
+    const ParamGenResolved* globalFilterParams = nullptr;
+    for (int i = 0; i < jobs.numVoices; ++i) {
+      const GrainNote& gNote = *jobs.voices[static_cast<size_t>(i)];
+      addToBuffer(gNote.mixBuffer, renderBuffer, renderStart, numChannels, renderSize);
+      if (gNote.globalFilterParams != nullptr) {
+        if (globalFilterParams == nullptr) mGlobalBuffer.clear(0, renderSize);
+        globalFilterParams = gNote.globalFilterParams;
+        addToBuffer(gNote.globalBuffer, mGlobalBuffer, 0, numChannels, renderSize);
       }
     }
-    mTotalSamps++;
+    if (globalFilterParams != nullptr) {
+      mPerf.lap(PerfCounters::Stage::RENDER, stageTimer);
+      applyFilter(mGlobalFilter, *globalFilterParams, mGlobalBuffer, numChannels, renderSize);
+      mPerf.lap(PerfCounters::Stage::FILTER, stageTimer);
+      addToBuffer(mGlobalBuffer, renderBuffer, renderStart, numChannels, renderSize);
+    }
+    if (mOversampler != nullptr) downsampleOutput(buffer, subBlockStart, numChannels, subBlockSize);
+    mPerf.lap(PerfCounters::Stage::RENDER, stageTimer);
+    mTotalSamps += renderSize;
+  }
+  for (RenderScratch& scratch : mRenderScratch) {
+    mPerf.addNanoseconds(PerfCounters::Stage::RENDER, scratch.renderNs);
+    mPerf.addNanoseconds(PerfCounters::Stage::FILTER, scratch.filterNs);
+    scratch.renderNs = 0;
+    scratch.filterNs = 0;
   }
 
   // Clip buffers to valid range
@@ -253,10 +362,10 @@ void GranularSynth::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuf
     juce::FloatVectorOperations::clip(buffer.getWritePointer(i), buffer.getReadPointer(i), -1.0f, 1.0f, bufferNumSample);
   }
 
-  handleGrainAddRemove(bufferNumSample);
+  removeExpiredGrains();
 
   // Reset timestamps if no grains active to keep numbers low
-  if (mActiveNotes.isEmpty()) {
+  if (mVoices.getNumActive() == 0) {
     mTotalSamps = 0;
   } else {
     // Normalize the block before sending onward
@@ -269,7 +378,233 @@ void GranularSynth::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuf
     } */
   }
 
+  stageTimer.tick();
   mMeterSource.measureBlock(buffer);
+  mPerf.lap(PerfCounters::Stage::METER, stageTimer);
+  mPerf.endBlock(blockTimer, mVoices.getNumActive(), mGrainPool.getNumActive());
+
+  // Only blocks that had a deadline to miss, a slow bounce isn't a problem
+  const float missThreshold = mParameters.engine.missThreshold.load();
+  const PerfCounters::BlockTimes& times = mPerf.getLastBlock();
+  if (!isNonRealtime() && missThreshold > 0.0f &&
+      static_cast<double>(times.blockNs) > missThreshold * static_cast<double>(times.deadlineNs)) {
+    recordDeadlineMiss(bufferNumSample);
+  }
+}
+
+void GranularSynth::setNumRenderThreads(int numThreads) {
+  // Only changes the setting of the mode the synth is in, the other one is picked up on the next prepareToPlay()
+  if (isOfflineQuality()) {
+    mOfflineRenderThreads = juce::jlimit(1, VoicePool::MAX_VOICES, numThreads);
+  } else {
+    mLiveRenderThreads = juce::jlimit(1, MAX_RENDER_THREADS, numThreads);
+  }
+  // Workers and scratch buffers can't change while a block is being rendered
+  suspendProcessing(true);
+  mRenderPool.setNumWorkers(getTargetRenderThreads() - 1);
+  prepareRenderScratch();
+  suspendProcessing(false);
+}
+
+int GranularSynth::getTargetRenderThreads() const {
+  if (!isOfflineQuality()) return mLiveRenderThreads;
+  // Bounces aren't racing a deadline so every core can be used, voices are the jobs so more threads than that would sit idle
+  return mOfflineRenderThreads > 0 ? mOfflineRenderThreads : juce::jmin(juce::SystemStats::getNumCpus(), VoicePool::MAX_VOICES);
+}
+
+void GranularSynth::prepareRenderScratch() {
+  const int numChannels = getTotalNumOutputChannels();
+  const int maxBlockSize = mGlobalBuffer.getNumSamples();
+  mRenderScratch.resize(static_cast<size_t>(mRenderPool.getNumThreads()));
+  for (RenderScratch& scratch : mRenderScratch) {
+    scratch.genBuffer.setSize(numChannels, maxBlockSize);
+    scratch.noteBuffer.setSize(numChannels, maxBlockSize);
+    scratch.laneBuffer.setSize(numChannels, maxBlockSize * FilterBank::NUM_LANES);
+    scratch.grainScratch.assign(static_cast<size_t>(maxBlockSize * SourcePyramid::MAX_CHANNELS), 0.0f);
+    scratch.ampEnvBuffer.assign(static_cast<size_t>(maxBlockSize), 0.0f);
+  }
+}
+
+void GranularSynth::recordDeadlineMiss(int numSamples) {
+  DeadlineRecorder::Snapshot* snapshot = mDeadlineRecorder.beginCapture();
+  if (snapshot == nullptr) return;
+
+  snapshot->timeMs = juce::Time::currentTimeMillis();
+  snapshot->sampleRate = mSampleRate;
+  snapshot->blockSize = numSamples;
+  snapshot->times = mPerf.getLastBlock();
+  snapshot->renderThreads = mRenderPool.getNumThreads();
+  snapshot->oversampling = mOversampling;
+  snapshot->interpolation = static_cast<int>(mInterpolation);
+  snapshot->governorScale = mLoadGovernor.getScale();
+  snapshot->bpm = mTransport.getBpm();
+  snapshot->numGrains = mGrainPool.getNumActive();
+  snapshot->numVoices = 0;
+  for (int voiceIdx = 0; voiceIdx < VoicePool::MAX_VOICES; ++voiceIdx) {
+    GrainNote* gNote = mVoices.getActive(voiceIdx);
+    if (gNote == nullptr) continue;
+    DeadlineRecorder::VoiceState& voice = snapshot->voices[static_cast<size_t>(snapshot->numVoices++)];
+    voice.midiNote = gNote->midiNote;
+    voice.velocity = gNote->velocity;
+    voice.releasing = gNote->removeTs >= 0;
+    voice.stolen = gNote->stealTs >= 0;
+    for (size_t genIdx = 0; genIdx < NUM_GENERATORS; ++genIdx) {
+      const ParamGenResolved& genParams = mParameters.resolved[gNote->pitchClass][genIdx];
+      DeadlineRecorder::GeneratorState& gen = voice.generators[genIdx];
+      gen.grains = gNote->genGrains[genIdx].size;
+      gen.playing = genParams.shouldPlay;
+      gen.sync = genParams.grainSync;
+      gen.filterType = static_cast<juce::int8>(genParams.filtType);
+      gen.filterScope = static_cast<juce::int8>(genParams.filtScope);
+    }
+  }
+  mDeadlineRecorder.endCapture();
+}
+
+void GranularSynth::renderVoiceJob(void* context, int job, int thread) {
+  RenderJobs& jobs = *static_cast<RenderJobs*>(context);
+  jobs.synth->renderVoice(*jobs.voices[static_cast<size_t>(job)], jobs.synth->mRenderScratch[static_cast<size_t>(thread)],
+                          jobs.numChannels, jobs.numSamples);
+}
+
+void GranularSynth::renderVoice(GrainNote& gNote, RenderScratch& scratch, int numChannels, int numSamples) {
+  PerfCounters::StageTimer stageTimer;
+  stageTimer.tick();
+  gNote.mixBuffer.clear(0, numSamples);
+  gNote.globalFilterParams = nullptr;
+  // Generators of this voice using the note filter params are summed and filtered together
+  const ParamGenResolved* noteFilterParams = nullptr;
+  // Generators with their own filter are filtered together in lanes of the voice's filter bank
+  bool lanesUsed = false;
+  for (size_t genIdx = 0; genIdx < NUM_GENERATORS; ++genIdx) {
+    const ParamGenResolved& genParams = mParameters.resolved[gNote.pitchClass][genIdx];
+    const float gain = genParams.gain;
+    const float attack = genParams.attack * mRenderRate;
+    const float decay = genParams.decay * mRenderRate;
+    const float sustain = genParams.sustain;
+    const float release = genParams.release * mRenderRate;
+    Utils::EnvelopeADSR& ampEnv = gNote.genAmpEnvs[genIdx];
+
+    if (gNote.genGrains[genIdx].isEmpty()) {
+      // Nothing to render, but still keep the envelope moving along
+      ampEnv.getAmplitude(mTotalSamps + numSamples - 1, attack, decay, sustain, release);
+      continue;
+    }
+
+    float* ampEnvBuffer = scratch.ampEnvBuffer.data();
+    for (int i = 0; i < numSamples; ++i) {
+      ampEnvBuffer[i] = ampEnv.getAmplitude(mTotalSamps + i, attack, decay, sustain, release) * gain;
+    }
+
+    juce::AudioBuffer<float>& genBuffer = scratch.genBuffer;
+    genBuffer.clear(0, numSamples);
+    for (int grainId : gNote.genGrains[genIdx]) {
+      mGrainPool.process(grainId, mSourcePyramid, genBuffer, scratch.grainScratch.data(), 0, numSamples, mTotalSamps,
+                         mInterpolation);
+    }
+    for (int ch = 0; ch < numChannels; ++ch) {
+      juce::FloatVectorOperations::multiply(genBuffer.getWritePointer(ch), ampEnvBuffer, numSamples);
+    }
+
+    // Route to the filter the params came from, skipping filtering completely if its type is "none". Under heavy load generator
+    // filters are folded into the voice's note filter, so a voice runs one filter instead of one per generator.
+    ParamType filtScope = genParams.filtScope;
+    if (filtScope == ParamType::GENERATOR && mLoadGovernor.shouldShareFilters()) filtScope = ParamType::NOTE;
+    if (genParams.filtType == Utils::FilterType::NO_FILTER) {
+      addToBuffer(genBuffer, gNote.mixBuffer, 0, numChannels, numSamples);
+    } else if (filtScope == ParamType::GENERATOR) {
+      if (!lanesUsed) scratch.laneBuffer.clear(0, numSamples * FilterBank::NUM_LANES);
+      lanesUsed = true;
+      gNote.genFilters.setLane(static_cast<int>(genIdx), genParams.filtType, genParams.filtCutoff, genParams.filtResonance);
+      for (int ch = 0; ch < numChannels; ++ch) {
+        const float* src = genBuffer.getReadPointer(ch);
+        float* lane = scratch.laneBuffer.getWritePointer(ch) + genIdx;
+        for (int i = 0; i < numSamples; ++i) {
+          lane[i * FilterBank::NUM_LANES] = src[i];
+        }
+      }
+    } else if (filtScope == ParamType::NOTE) {
+      if (noteFilterParams == nullptr) scratch.noteBuffer.clear(0, numSamples);
+      noteFilterParams = &genParams;
+      addToBuffer(genBuffer, scratch.noteBuffer, 0, numChannels, numSamples);
+    } else {
+      if (gNote.globalFilterParams == nullptr) gNote.globalBuffer.clear(0, numSamples);
+      gNote.globalFilterParams = &genParams;
+      addToBuffer(genBuffer, gNote.globalBuffer, 0, numChannels, numSamples);
+    }
+  }
+
+  if (lanesUsed) {
+    scratch.renderNs += PerfCounters::lap(stageTimer);
+    gNote.genFilters.processAndSum(scratch.laneBuffer.getArrayOfReadPointers(), gNote.mixBuffer, numChannels, numSamples);
+    scratch.filterNs += PerfCounters::lap(stageTimer);
+  }
+  if (noteFilterParams != nullptr) {
+    scratch.renderNs += PerfCounters::lap(stageTimer);
+    applyFilter(gNote.noteFilter, *noteFilterParams, scratch.noteBuffer, numChannels, numSamples);
+    scratch.filterNs += PerfCounters::lap(stageTimer);
+    addToBuffer(scratch.noteBuffer, gNote.mixBuffer, 0, numChannels, numSamples);
+  }
+
+  // Stolen voices fade out quickly instead of being cut
+  if (gNote.stealTs != -1) {
+    const float fadeSamples = static_cast<float>(gNote.removeTs - gNote.stealTs);
+    const float startGain = juce::jmax(0.0f, 1.0f - (mTotalSamps - gNote.stealTs) / fadeSamples);
+    const float endGain = juce::jmax(0.0f, 1.0f - (mTotalSamps + numSamples - gNote.stealTs) / fadeSamples);
+    gNote.mixBuffer.applyGainRamp(0, numSamples, startGain, endGain);
+    if (gNote.globalFilterParams != nullptr) gNote.globalBuffer.applyGainRamp(0, numSamples, startGain, endGain);
+  }
+  scratch.renderNs += PerfCounters::lap(stageTimer);
+}
+
+void GranularSynth::applyFilter(juce::dsp::StateVariableTPTFilter<float>& filter, const ParamGenResolved& params,
+                                juce::AudioBuffer<float>& samples, int numChannels, int numSamples) {
+  switch (params.filtType) {
+    case Utils::FilterType::LOWPASS:
+      filter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
+      break;
+    case Utils::FilterType::HIGHPASS:
+      filter.setType(juce::dsp::StateVariableTPTFilterType::highpass);
+      break;
+    case Utils::FilterType::BANDPASS:
+      filter.setType(juce::dsp::StateVariableTPTFilterType::bandpass);
+      break;
+    default:
+      break;
+  }
+  filter.setCutoffFrequency(params.filtCutoff);
+  filter.setResonance(params.filtResonance);
+
+  juce::dsp::AudioBlock<float> block = juce::dsp::AudioBlock<float>(samples)
+                                           .getSubsetChannelBlock(0, static_cast<size_t>(numChannels))
+                                           .getSubBlock(0, static_cast<size_t>(numSamples));
+  filter.process(juce::dsp::ProcessContextReplacing<float>(block));
+}
+
+void GranularSynth::upsampleOutput(juce::AudioBuffer<float>& buffer, int startSample, int numChannels, int numSamples) {
+  jassert(numChannels <= MAX_OUTPUT_CHANNELS);
+  const juce::dsp::AudioBlock<float> outBlock = juce::dsp::AudioBlock<float>(buffer)
+                                                    .getSubsetChannelBlock(0, static_cast<size_t>(numChannels))
+                                                    .getSubBlock(static_cast<size_t>(startSample), static_cast<size_t>(numSamples));
+  juce::dsp::AudioBlock<float> upBlock = mOversampler->processSamplesUp(outBlock);
+  // Only points at the oversampler's own buffer, a handful of channels fit in the buffer's preallocated space
+  std::array<float*, MAX_OUTPUT_CHANNELS> channels = {};
+  for (int ch = 0; ch < numChannels; ++ch) channels[static_cast<size_t>(ch)] = upBlock.getChannelPointer(static_cast<size_t>(ch));
+  mOversampledBuffer.setDataToReferTo(channels.data(), numChannels, static_cast<int>(upBlock.getNumSamples()));
+}
+
+void GranularSynth::downsampleOutput(juce::AudioBuffer<float>& buffer, int startSample, int numChannels, int numSamples) {
+  juce::dsp::AudioBlock<float> downBlock = juce::dsp::AudioBlock<float>(buffer)
+                                               .getSubsetChannelBlock(0, static_cast<size_t>(numChannels))
+                                               .getSubBlock(static_cast<size_t>(startSample), static_cast<size_t>(numSamples));
+  mOversampler->processSamplesDown(downBlock);
+}
+
+void GranularSynth::addToBuffer(const juce::AudioBuffer<float>& source, juce::AudioBuffer<float>& dest, int destStartSample,
+                                int numChannels, int numSamples) {
+  for (int ch = 0; ch < numChannels; ++ch) {
+    dest.addFrom(ch, destStartSample, source, ch, 0, numSamples);
+  }
 }
 
 //==============================================================================
@@ -298,6 +633,7 @@ void GranularSynth::getStateInformation(juce::MemoryBlock& destData) {
   xml.addChildElement(params);
   xml.addChildElement(mParameters.note.getXml());
   xml.addChildElement(mParameters.ui.getXml());
+  xml.addChildElement(mParameters.engine.getXml());
 
   copyXmlToBinary(xml, destData);
 }
@@ -326,6 +662,8 @@ void GranularSynth::setStateInformation(const void* data, int sizeInBytes) {
       mParameters.ui.setXml(params);
     }
 
+    mParameters.engine.setXml(xml->getChildByName("ParamEngine"));
+
     // Load the file if we haven't yet
     if (mAudioBuffer.getNumSamples() == 0 && mParameters.ui.loadedFileName.isNotEmpty()) {
       juce::File file = juce::File(mParameters.ui.loadedFileName);
@@ -348,6 +686,7 @@ void GranularSynth::getPresetParamsXml(juce::MemoryBlock& destData) {
   xml.addChildElement(audioParams);
   xml.addChildElement(mParameters.note.getXml());
   xml.addChildElement(mParameters.ui.getXml());
+  xml.addChildElement(mParameters.engine.getXml());
 
   copyXmlToBinary(xml, destData);
 }
@@ -372,6 +711,11 @@ void GranularSynth::setPresetParamsXml(const void* data, int sizeInBytes) {
     if (params != nullptr) {
       mParameters.ui.setXml(params);
     }
+
+    params = xml->getChildByName("ParamEngine");
+    if (params != nullptr) {
+      mParameters.engine.setXml(params);
+    }
   }
 }
 
@@ -395,109 +739,113 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter() {
   return synth;
 }
 
-void GranularSynth::handleGrainAddRemove(int blockSize) {
-  if (mParameters.ui.specComplete) {
-    // Add one grain per active note
-    for (GrainNote* gNote : mActiveNotes) {
-      for (size_t i = 0; i < gNote->grainTriggers.size(); ++i) {
-        if (gNote->grainTriggers[i] <= 0) {
-          ParamGenerator* paramGenerator = mParameters.note.notes[gNote->pitchClass]->generators[i].get();
-          ParamCandidate* paramCandidate = mParameters.note.notes[gNote->pitchClass]->getCandidate(i);
-          float durSec;
-          const float gain = mParameters.getFloatParam(paramGenerator, ParamCommon::Type::GAIN);
-          const float grainRate = mParameters.getFloatParam(paramGenerator, ParamCommon::Type::GRAIN_RATE);
-          const float grainDuration = mParameters.getFloatParam(paramGenerator, ParamCommon::Type::GRAIN_DURATION);
-          const bool grainSync = mParameters.getBoolParam(paramGenerator, ParamCommon::Type::GRAIN_SYNC);
-          const float pitchAdjust = mParameters.getFloatParam(paramGenerator, ParamCommon::Type::PITCH_ADJUST);
-          const float pitchSpray = mParameters.getFloatParam(paramGenerator, ParamCommon::Type::PITCH_SPRAY);
-          const float posAdjust = mParameters.getFloatParam(paramGenerator, ParamCommon::Type::POS_ADJUST);
-          const float posSpray = mParameters.getFloatParam(paramGenerator, ParamCommon::Type::POS_SPRAY);
-          const float panAdjust = mParameters.getFloatParam(paramGenerator, ParamCommon::Type::PAN_ADJUST);
-          const float panSpray = mParameters.getFloatParam(paramGenerator, ParamCommon::Type::PAN_SPRAY);
-          const std::vector<float> grainEnv = mParameters.getGrainEnv(paramGenerator);
-
-          if (grainSync) {
-            float div = std::pow(2, (int)(ParamRanges::SYNC_DIV_MAX * ParamRanges::GRAIN_DURATION.convertTo0to1(grainDuration)));
-            double bpm = DEFAULT_BPM;
-            int beatsPerBar = 4;
-            if (juce::AudioPlayHead* playhead = getPlayHead()) {
-              juce::Optional<juce::AudioPlayHead::PositionInfo> info = playhead->getPosition();
-              juce::Optional<double> newBpm = info->getBpm();
-              if (newBpm) {
-                bpm = *newBpm;
-              }
-              juce::Optional<juce::AudioPlayHead::TimeSignature> newTimeSignature = info->getTimeSignature();
-              if (newTimeSignature) {
-                beatsPerBar = (*newTimeSignature).numerator;
-              }
-            }
-            // Find synced duration using bpm
-            durSec = (1.0f / bpm) * 60.0f * (beatsPerBar / div);
-          } else {
-            durSec = grainDuration;
-          }
-          // Skip adding new grain if not enabled or full of grains
-          if (paramCandidate != nullptr && mParameters.note.notes[gNote->pitchClass]->shouldPlayGenerator(i) &&
-              gNote->genGrains.size() < MAX_GRAINS) {
-            float durSamples = mSampleRate * durSec * (1.0f / paramCandidate->pbRate);
-            /* Position calculation */
-            juce::Random random;
-            float posSprayOffset = juce::jmap(random.nextFloat(), ParamRanges::POSITION_SPRAY.start, posSpray) * mSampleRate;
-            if (random.nextFloat() > 0.5f) posSprayOffset = -posSprayOffset;
-            float posOffset = posAdjust * durSamples + posSprayOffset;
-            float posSamples = paramCandidate->posRatio * mAudioBuffer.getNumSamples() + posOffset;
-
-            /* Pan offset */
-            float panSprayOffset = random.nextFloat() * panSpray;
-            if (random.nextFloat() > 0.5f) panSprayOffset = -panSprayOffset;
-            const float panOffset = juce::jlimit(ParamRanges::PAN_ADJUST.start, ParamRanges::PAN_ADJUST.end, panAdjust + panSprayOffset);
-
-            /* Pitch calculation */
-            float pitchSprayOffset = juce::jmap(random.nextFloat(), 0.0f, pitchSpray);
-            if (random.nextFloat() > 0.5f) pitchSprayOffset = -pitchSprayOffset;
-            float pbRate = paramCandidate->pbRate + pitchAdjust + pitchSprayOffset;
-            jassert(paramCandidate->pbRate > 0.1f);
-
-            /* Add grain */
-            auto grain = Grain(grainEnv, durSamples, pbRate, posSamples, mTotalSamps, gain, panOffset);
-            gNote->genGrains[i].add(grain);
-
-            /* Trigger grain in arcspec */
-            float totalGain = gain * gNote->genAmpEnvs[i].amplitude * gNote->velocity;
-            mParameters.note.grainCreated(gNote->pitchClass, i, durSec / pbRate, totalGain);
-          }
-          // Reset trigger ts
-          if (grainSync) {
-            float div = std::pow(2, (int)(ParamRanges::SYNC_DIV_MAX * ParamRanges::GRAIN_RATE.convertTo0to1(grainRate)));
-            // Find synced rate interval using bpm
-            float intervalSamples = mSampleRate * durSec / div;
-            gNote->grainTriggers[i] += intervalSamples;
-          } else {
-            gNote->grainTriggers[i] += mSampleRate * juce::jmap(ParamRanges::GRAIN_RATE.convertTo0to1(grainRate),
-                                         durSec * MIN_RATE_RATIO, durSec * MAX_RATE_RATIO);
-          }
-        } else {
-          gNote->grainTriggers[i] -= blockSize;
-        }
-      }
-    }
+void GranularSynth::triggerGrains(int numSamples) {
+  // Triggers are held until there are candidates to play, any that are overdue by then start at the beginning of the block
+  if (!mParameters.ui.specComplete) return;
+
+  const long blockEndTs = mTotalSamps + numSamples;
+  while (!mScheduler.isEmpty() && mScheduler.top().ts < blockEndTs) {
+    const GrainScheduler::Trigger trigger = mScheduler.top();
+    mScheduler.pop();
+    GrainNote* gNote = mVoices.getActive(trigger.voice);
+    if (gNote == nullptr) continue;
+
+    const double trigTs = juce::jmax(trigger.ts, static_cast<double>(mTotalSamps));
+    const double nextTs = addGrain(*gNote, static_cast<size_t>(trigger.gen), static_cast<long>(trigTs));
+    // At least a sample apart so a zero interval can't stall the block
+    mScheduler.push(juce::jmax(nextTs, trigTs + 1.0), trigger.voice, trigger.gen);
+  }
+}
+
+double GranularSynth::addGrain(GrainNote& gNote, size_t genIdx, long trigTs) {
+  const ParamGenResolved& genParams = mParameters.resolved[gNote.pitchClass][genIdx];
+  ParamCandidate* paramCandidate = mParameters.note.notes[gNote.pitchClass]->getCandidate(genIdx);
+  float durSec;
+  const float gain = genParams.gain;
+  const float grainRate = genParams.grainRate;
+  const float grainDuration = genParams.grainDuration;
+  const bool grainSync = genParams.grainSync;
+  const float pitchAdjust = genParams.pitchAdjust;
+  const float pitchSpray = genParams.pitchSpray;
+  const float posAdjust = genParams.posAdjust;
+  const float posSpray = genParams.posSpray;
+  const float panAdjust = genParams.panAdjust;
+  const float panSpray = genParams.panSpray;
+
+  // Synced durations are a fraction of a bar of the block's transport snapshot
+  const double syncDurBeats = mTransport.getBarBeats() / genParams.syncDurationDiv;
+  if (grainSync) {
+    durSec = static_cast<float>(syncDurBeats * mTransport.getSamplesPerBeat() / mRenderRate);
+  } else {
+    durSec = grainDuration;
   }
-  // Delete expired grains
-  for (GrainNote* gNote : mActiveNotes) {
-    for (int genIdx = 0; genIdx < NUM_GENERATORS; ++genIdx) {
-      gNote->genGrains[genIdx].removeIf([this](Grain& g) { return mTotalSamps > (g.trigTs + g.duration); });
+  // Skip adding new grain if not enabled or full of grains, the governor lowers how many grains make it full under load
+  const int maxGrains = mLoadGovernor.getMaxGrains(GrainList::MAX_GRAINS);
+  if (paramCandidate != nullptr && genParams.shouldPlay && gNote.genGrains[genIdx].size >= maxGrains) mPerf.addDroppedGrain();
+  if (paramCandidate != nullptr && genParams.shouldPlay && gNote.genGrains[genIdx].size < maxGrains) {
+    // Timestamps and durations are in render samples, positions and read increments in source samples
+    float durSamples = mRenderRate * durSec * (1.0f / paramCandidate->pbRate);
+    /* Position calculation */
+    Utils::FastRandom& random = gNote.random;
+    float posSprayOffset = juce::jmap(random.nextFloat(), ParamRanges::POSITION_SPRAY.start, posSpray) * mSampleRate;
+    if (random.nextBool()) posSprayOffset = -posSprayOffset;
+    float posOffset = posAdjust * durSamples / mOversampling + posSprayOffset;
+    float posSamples = paramCandidate->posRatio * mAudioBuffer.getNumSamples() + posOffset;
+
+    /* Pan offset */
+    float panSprayOffset = random.nextFloat() * panSpray;
+    if (random.nextBool()) panSprayOffset = -panSprayOffset;
+    const float panOffset = juce::jlimit(ParamRanges::PAN_ADJUST.start, ParamRanges::PAN_ADJUST.end, panAdjust + panSprayOffset);
+
+    /* Pitch calculation */
+    float pitchSprayOffset = juce::jmap(random.nextFloat(), 0.0f, pitchSpray);
+    if (random.nextBool()) pitchSprayOffset = -pitchSprayOffset;
+    float pbRate = paramCandidate->pbRate + pitchAdjust + pitchSprayOffset;
+    jassert(paramCandidate->pbRate > 0.1f);
+
+    /* Add grain */
+    const int grainId = mGrainPool.add(genParams.grainShape, genParams.grainTilt, durSamples, pbRate / mOversampling, posSamples,
+                                       trigTs, panOffset);
+    if (grainId != GrainPool::INVALID_GRAIN) {
+      gNote.genGrains[genIdx].add(grainId);
+
+      /* Trigger grain in arcspec */
+      float totalGain = gain * gNote.genAmpEnvs[genIdx].amplitude * gNote.velocity;
+      mParameters.note.grainCreated(gNote.pitchClass, genIdx, durSec / pbRate, totalGain);
+    } else {
+      mPerf.addDroppedGrain();
     }
   }
+  // When the next grain of this generator is due, spread further apart when the governor is backing off
+  if (grainSync) {
+    // Locked to the host's grid, lines are skipped instead of stretched so grains stay on the beat under load
+    const double gridBeats = syncDurBeats / genParams.syncRateDiv;
+    return mTransport.getNextGridTs(static_cast<double>(trigTs), gridBeats * std::ceil(mLoadGovernor.getIntervalScale()));
+  }
+  const double interval = mRenderRate * juce::jmap(ParamRanges::GRAIN_RATE.convertTo0to1(grainRate), durSec * MIN_RATE_RATIO,
+                                                   durSec * MAX_RATE_RATIO);
+  return static_cast<double>(trigTs) + interval * mLoadGovernor.getIntervalScale();
+}
+
+void GranularSynth::removeExpiredGrains() {
+  for (int voiceIdx = 0; voiceIdx < VoicePool::MAX_VOICES; ++voiceIdx) {
+    GrainNote* gNote = mVoices.getActive(voiceIdx);
+    if (gNote == nullptr) continue;
 
-  // Delete expired notes
-  std::vector<GrainNote*> notesToRemove;
-  for (auto* gNote : mActiveNotes) {
     if (gNote->removeTs != -1 && mTotalSamps >= gNote->removeTs) {
-      notesToRemove.push_back(gNote);
+      retireVoice(*gNote);
+      continue;
+    }
+
+    // Give expired grains back to the pool
+    for (GrainList& grains : gNote->genGrains) {
+      for (int g = grains.size - 1; g >= 0; --g) {
+        if (mGrainPool.isExpired(grains.ids[g], mTotalSamps)) {
+          mGrainPool.remove(grains.ids[g]);
+          grains.removeAt(g);
+        }
+      }
     }
-  }
-  for (auto* gNote : notesToRemove) {
-    mActiveNotes.removeObject(gNote);
   }
 }
 
@@ -507,8 +855,12 @@ Utils::Result GranularSynth::loadAudioFile(juce::File file, bool process) {
 
   juce::AudioBuffer<float> fileAudioBuffer;
   const int length = static_cast<int>(formatReader->lengthInSamples);
-  fileAudioBuffer.setSize(1, length);
-  formatReader->read(&fileAudioBuffer, 0, length, 0, true, false);
+  fileAudioBuffer.setSize(static_cast<int>(formatReader->numChannels), length);
+  formatReader->read(&fileAudioBuffer, 0, length, 0, true, true);
+  // Grains are only ever played back in stereo
+  if (fileAudioBuffer.getNumChannels() > SourcePyramid::MAX_CHANNELS) {
+    foldAudioBuffer(fileAudioBuffer, SourcePyramid::MAX_CHANNELS);
+  }
 
   // .mp3 files, unlike .wav files, can contain PCM values greater than abs(1.0) (aka, clipping) which will produce aweful
   // sounding grains, so normalize the gain of any mp3 file clipping before using anywhere
@@ -530,7 +882,11 @@ Utils::Result GranularSynth::loadAudioFile(juce::File file, bool process) {
   }
   else {
     if (mSampleRate != INVALID_SAMPLE_RATE) {
+      // Grains read the source and its levels during a block, neither can be freed until no block is being rendered
+      suspendProcessing(true);
       resampleAudioBuffer(fileAudioBuffer, mAudioBuffer, formatReader->sampleRate, mSampleRate);
+      mSourcePyramid.build();
+      suspendProcessing(false);
       mParameters.ui.loadingProgress = RESET_LOADING_PROGRESS;
     }
     else {
@@ -562,7 +918,12 @@ Utils::Result GranularSynth::loadPreset(juce::File file) {
     if (header.versionMajor == 0) {
       // Get Audio Buffer blob
       fileAudioBuffer.setSize(header.audioBufferChannel, header.audioBufferNumberOfSamples);
-      input.read(fileAudioBuffer.getWritePointer(0), header.audioBufferSize);
+      for (int c = 0; c < fileAudioBuffer.getNumChannels(); c++) {
+        input.read(fileAudioBuffer.getWritePointer(c), header.audioBufferNumberOfSamples * sizeof(float));
+      }
+      if (fileAudioBuffer.getNumChannels() > SourcePyramid::MAX_CHANNELS) {
+        foldAudioBuffer(fileAudioBuffer, SourcePyramid::MAX_CHANNELS);
+      }
       sampleRate = header.audioBufferSamplerRate;
 
       // Get offsets and load all png for spec images
@@ -597,7 +958,10 @@ Utils::Result GranularSynth::loadPreset(juce::File file) {
     }
 
     if (mSampleRate != INVALID_SAMPLE_RATE) {
+      suspendProcessing(true);
       resampleAudioBuffer(fileAudioBuffer, mAudioBuffer, sampleRate, mSampleRate);
+      mSourcePyramid.build();
+      suspendProcessing(false);
     } else {
       mInputBuffer = fileAudioBuffer;  // Save for resampling once prepareToPlay() has been called
       mSampleRate = sampleRate;        // A bit hacky, but we need to store the file's sample rate for resampling
@@ -633,6 +997,21 @@ void GranularSynth::resampleAudioBuffer(juce::AudioBuffer<float>& inputBuffer, j
   if (clearInput) inputBuffer.setSize(1, 1);
 }
 
+void GranularSynth::foldAudioBuffer(juce::AudioBuffer<float>& buffer, int numChannels) {
+  // Every channel past numChannels is mixed into the output channel it lines up with when counting round, so for 5.1 the left
+  // side channels end up on the left and the right ones on the right
+  const int numSamples = buffer.getNumSamples();
+  std::vector<int> numFolded(static_cast<size_t>(numChannels), 1);
+  for (int c = numChannels; c < buffer.getNumChannels(); c++) {
+    buffer.addFrom(c % numChannels, 0, buffer, c, 0, numSamples);
+    numFolded[static_cast<size_t>(c % numChannels)]++;
+  }
+  for (int c = 0; c < numChannels; c++) {
+    buffer.applyGain(c, 0, numSamples, 1.0f / static_cast<float>(numFolded[static_cast<size_t>(c)]));
+  }
+  buffer.setSize(numChannels, numSamples, true);
+}
+
 void GranularSynth::trimAudioBuffer(juce::AudioBuffer<float>& inputBuffer, juce::AudioBuffer<float>& outputBuffer,
                                     juce::Range<juce::int64> range, bool clearInput) {
   if (range.isEmpty()) {
@@ -649,6 +1028,13 @@ void GranularSynth::trimAudioBuffer(juce::AudioBuffer<float>& inputBuffer, juce:
   if (clearInput) inputBuffer.setSize(1, 1);
 }
 
+void GranularSynth::trimSource(juce::Range<juce::int64> range) {
+  suspendProcessing(true);
+  trimAudioBuffer(mInputBuffer, mAudioBuffer, range);
+  mSourcePyramid.build();
+  suspendProcessing(false);
+}
+
 void GranularSynth::extractPitches() {
   // Cancel processing if in progress
   mPitchDetector.cancelProcessing();
@@ -675,40 +1061,170 @@ std::vector<ParamCandidate*> GranularSynth::getActiveCandidates() {
   return candidates;
 }
 
-void GranularSynth::handleNoteOn(juce::MidiKeyboardState*, int, int midiNoteNumber, float velocity) {
+void GranularSynth::handleMidiMessage(const juce::MidiMessage& message, long ts) {
+  if (message.isNoteOn()) {
+    handleNoteOn(message.getNoteNumber(), message.getFloatVelocity(), ts);
+  } else if (message.isNoteOff()) {
+    handleNoteOff(message.getNoteNumber(), ts);
+  } else if (message.isAllNotesOff() || message.isAllSoundOff()) {
+    for (int midiNoteNumber = 0; midiNoteNumber < static_cast<int>(mMidiNotesOn.size()); ++midiNoteNumber) {
+      handleNoteOff(midiNoteNumber, ts);
+    }
+  }
+}
+
+void GranularSynth::handleNoteOn(int midiNoteNumber, float velocity, long ts) {
+  mMidiNotesOn.set(static_cast<size_t>(midiNoteNumber));
   mLastPitchClass = Utils::getPitchClass(midiNoteNumber);
-  mMidiNotes.add(Utils::MidiNote(mLastPitchClass, velocity));
-  mActiveNotes.add(new GrainNote(mLastPitchClass, velocity, Utils::EnvelopeADSR(mTotalSamps)));
+  if (mHeldNotes.size < static_cast<int>(mHeldNotes.notes.size())) {
+    mHeldNotes.notes[static_cast<size_t>(mHeldNotes.size++)] = Utils::MidiNote(mLastPitchClass, velocity);
+    mHeldNotesChanged = true;
+  }
+
+  // Voices past the limit (including ones still releasing) make room by fading out the cheapest to lose
+  int numSounding = 0;
+  for (int voiceIdx = 0; voiceIdx < VoicePool::MAX_VOICES; ++voiceIdx) {
+    GrainNote* gNote = mVoices.getActive(voiceIdx);
+    if (gNote == nullptr) continue;
+    if (gNote->midiNote == midiNoteNumber && gNote->removeTs == -1) {
+      // Same key pressed again without a note off in between, let the old one release
+      releaseVoice(*gNote, ts);
+    }
+    if (gNote->stealTs == -1) numSounding++;
+  }
+  for (; numSounding >= mParameters.engine.maxVoices.load(); --numSounding) {
+    GrainNote* victim = findVoiceToSteal(false);
+    if (victim == nullptr) break;
+    const long fadeEndTs = mTotalSamps + static_cast<long>(STEAL_FADE_SEC * mRenderRate) + 1;
+    victim->stealTs = mTotalSamps;
+    victim->removeTs = victim->removeTs == -1 ? fadeEndTs : juce::jmin(victim->removeTs, fadeEndTs);
+  }
+
+  GrainNote* gNote = mVoices.acquire();
+  if (gNote == nullptr) {
+    // Every voice is busy fading out, cut the one closest to done
+    GrainNote* victim = findVoiceToSteal(true);
+    if (victim == nullptr) return;
+    retireVoice(*victim);
+    gNote = mVoices.acquire();
+    if (gNote == nullptr) return;
+  }
+  gNote->start(midiNoteNumber, mLastPitchClass, velocity, ts);
+  // Each voice sprays from its own generator, seeded from the project seed, note and start time so the same notes played at the
+  // same times always spray the same way
+  const juce::uint64 noteKey = (static_cast<juce::uint64>(ts) << 7) | static_cast<juce::uint64>(midiNoteNumber);
+  gNote->random.setSeed(static_cast<juce::uint64>(mParameters.engine.seed.load()) ^ Utils::FastRandom::mix(noteKey));
+  mVoices.activate(gNote);
+  // First grain of each generator starts with the note
+  for (int genIdx = 0; genIdx < NUM_GENERATORS; ++genIdx) {
+    mScheduler.push(static_cast<double>(ts), mVoices.getIndex(gNote), genIdx);
+  }
 }
 
-void GranularSynth::handleNoteOff(juce::MidiKeyboardState*, int, int midiNoteNumber, float) {
+void GranularSynth::handleNoteOff(int midiNoteNumber, long ts) {
+  if (!mMidiNotesOn.test(static_cast<size_t>(midiNoteNumber))) return;
+  mMidiNotesOn.reset(static_cast<size_t>(midiNoteNumber));
   const Utils::PitchClass pitchClass = Utils::getPitchClass(midiNoteNumber);
 
-  for (Utils::MidiNote* it = mMidiNotes.begin(); it != mMidiNotes.end(); it++) {
-    if (it->pitch == pitchClass) {
-      mMidiNotes.remove(it);
+  for (int i = 0; i < mHeldNotes.size; ++i) {
+    if (mHeldNotes.notes[static_cast<size_t>(i)].pitch == pitchClass) {
+      // Shift down to keep the order notes were pressed in
+      std::copy(mHeldNotes.notes.begin() + i + 1, mHeldNotes.notes.begin() + mHeldNotes.size, mHeldNotes.notes.begin() + i);
+      mHeldNotes.size--;
+      mHeldNotesChanged = true;
       break;  // will only be at most 1 note (TODO assuming mouse and midi aren't set at same time)
     }
   }
 
-  for (GrainNote* gNote : mActiveNotes) {
-    if (gNote->pitchClass == pitchClass && gNote->removeTs == -1) {
-      // Set timestamp to delete note based on release time and set note off for all generators
-      float maxRelease = 0;
-      for (size_t i = 0; i < NUM_GENERATORS; ++i) {
-        gNote->genAmpEnvs[i].noteOff(mTotalSamps);
-        // Update max release time
-        float release =
-            mParameters.getFloatParam(mParameters.note.notes[gNote->pitchClass]->generators[i].get(), ParamCommon::Type::RELEASE);
-        if (release >= maxRelease) maxRelease = release;
-      }
-      gNote->removeTs = mTotalSamps + (maxRelease * mSampleRate);
-
+  for (int voiceIdx = 0; voiceIdx < VoicePool::MAX_VOICES; ++voiceIdx) {
+    GrainNote* gNote = mVoices.getActive(voiceIdx);
+    if (gNote != nullptr && gNote->midiNote == midiNoteNumber && gNote->removeTs == -1) {
+      releaseVoice(*gNote, ts);
       break;
     }
   }
 }
 
+void GranularSynth::releaseVoice(GrainNote& gNote, long ts) {
+  // Set timestamp to delete note based on release time and set note off for all generators
+  float maxRelease = 0;
+  for (size_t i = 0; i < NUM_GENERATORS; ++i) {
+    const ParamGenResolved& genParams = mParameters.resolved[gNote.pitchClass][i];
+    gNote.genAmpEnvs[i].noteOff(ts, genParams.attack * mRenderRate, genParams.decay * mRenderRate, genParams.sustain);
+    // Update max release time
+    const float release = genParams.release;
+    if (release >= maxRelease) maxRelease = release;
+  }
+  gNote.removeTs = ts + (maxRelease * mRenderRate);
+}
+
+void GranularSynth::retireVoice(GrainNote& gNote) {
+  // Note is done, give all its grains, triggers and the voice back
+  mScheduler.removeVoice(mVoices.getIndex(&gNote));
+  for (GrainList& grains : gNote.genGrains) {
+    for (int grainId : grains) {
+      mGrainPool.remove(grainId);
+    }
+    grains.size = 0;
+  }
+  mVoices.release(&gNote);
+}
+
+GrainNote* GranularSynth::findVoiceToSteal(bool fading) {
+  // How loud a voice currently is, bucketed so voices about as loud are compared by cost instead
+  auto getLevel = [this](const GrainNote& gNote) {
+    float level = 0.0f;
+    for (size_t i = 0; i < NUM_GENERATORS; ++i) {
+      level = juce::jmax(level, gNote.genAmpEnvs[i].amplitude * mParameters.resolved[gNote.pitchClass][i].gain);
+    }
+    return static_cast<int>(level * gNote.velocity * STEAL_LEVEL_STEPS);
+  };
+  // Estimated render cost, every grain of every generator is rendered each block
+  auto getCost = [](const GrainNote& gNote) {
+    int numGrains = 0;
+    for (const GrainList& grains : gNote.genGrains) {
+      numGrains += grains.size;
+    }
+    return numGrains;
+  };
+
+  GrainNote* victim = nullptr;
+  for (int voiceIdx = 0; voiceIdx < VoicePool::MAX_VOICES; ++voiceIdx) {
+    GrainNote* gNote = mVoices.getActive(voiceIdx);
+    if (gNote == nullptr || (gNote->stealTs != -1) != fading) continue;
+    if (victim == nullptr) {
+      victim = gNote;
+      continue;
+    }
+    if (fading) {
+      if (gNote->removeTs < victim->removeTs) victim = gNote;
+      continue;
+    }
+
+    // Prefer voices already releasing, then quieter, then more expensive, then older
+    const bool isReleasing = gNote->removeTs != -1;
+    const bool victimReleasing = victim->removeTs != -1;
+    if (isReleasing != victimReleasing) {
+      if (isReleasing) victim = gNote;
+      continue;
+    }
+    const int level = getLevel(*gNote);
+    const int victimLevel = getLevel(*victim);
+    if (level != victimLevel) {
+      if (level < victimLevel) victim = gNote;
+      continue;
+    }
+    const int cost = getCost(*gNote);
+    const int victimCost = getCost(*victim);
+    if (cost != victimCost) {
+      if (cost > victimCost) victim = gNote;
+      continue;
+    }
+    if (gNote->startTs < victim->startTs) victim = gNote;
+  }
+  return victim;
+}
+
 void GranularSynth::resetParameters(bool fullClear) {
   mParameters.note.resetParams(fullClear);
   mParameters.global.resetParams();
@@ -12,15 +12,27 @@
 
 #include <juce_audio_basics/juce_audio_basics.h>
 
-#include "Grain.h"
+#include "GrainPool.h"
+#include "VoicePool.h"
+#include "GrainScheduler.h"
+#include "RenderPool.h"
+#include "LoadGovernor.h"
+#include "PerfCounters.h"
+#include "DeadlineRecorder.h"
+#include "Transport.h"
+#include "SourcePyramid.h"
 #include "PitchDetector.h"
 #include "Parameters.h"
 #include "Utils/Utils.h"
 #include "Utils/MidiNote.h"
+#include "Utils/NoteEventFifo.h"
+#include "Utils/DoubleBuffer.h"
 #include <bitset>
 #include "ff_meters/ff_meters.h"
 
-class GranularSynth : public juce::AudioProcessor, juce::MidiKeyboardState::Listener {
+static_assert(PerfCounters::NUM_VOICE_BINS == VoicePool::MAX_VOICES + 1, "Needs a histogram bin for every number of voices");
+
+class GranularSynth : public juce::AudioProcessor {
  public:
   enum ParameterType {
     ENABLED,  // If position is enabled and playing grains
@@ -78,7 +90,8 @@ class GranularSynth : public juce::AudioProcessor, juce::MidiKeyboardState::List
 
   double getSampleRate() { return mSampleRate; }
   juce::AudioBuffer<float>& getAudioBuffer() { return mAudioBuffer; }
-  juce::MidiKeyboardState& getKeyboardState() { return mKeyboardState; }
+  // Notes from the on-screen keyboard, only to be pushed to from the message thread
+  Utils::NoteEventFifo& getUiNoteEvents() { return mUiNoteEvents; }
   juce::AudioFormatManager& getFormatManager() { return mFormatManager; }
   juce::AudioBuffer<float>& getInputBuffer() { return mInputBuffer; }
   Utils::Result loadAudioFile(juce::File file, bool process);
@@ -89,6 +102,11 @@ class GranularSynth : public juce::AudioProcessor, juce::MidiKeyboardState::List
 
   void trimAudioBuffer(juce::AudioBuffer<float>& inputBuffer, juce::AudioBuffer<float>& outputBuffer,
                        juce::Range<juce::int64> range, bool clearInput = false);
+  // Replaces the synth's source with range of the input buffer and starts rebuilding its decimated levels. Grains read both, so
+  // processing is suspended while they're swapped.
+  void trimSource(juce::Range<juce::int64> range);
+  // Mixes a buffer with more channels than numChannels down to numChannels in place
+  void foldAudioBuffer(juce::AudioBuffer<float>& buffer, int numChannels);
 
   void extractPitches();
   void extractSpectrograms();
@@ -102,10 +120,29 @@ class GranularSynth : public juce::AudioProcessor, juce::MidiKeyboardState::List
   ParamUI& getParamUI() { return mParameters.ui; }
   void resetParameters(bool fullClear = true);
 
-  const juce::Array<Utils::MidiNote>& getMidiNotes() { return mMidiNotes; }
+  // Last set of held notes published by the audio thread, safe to call from any thread
+  juce::Array<Utils::MidiNote> getMidiNotes() const {
+    const HeldNotes heldNotes = mHeldNotesSnapshot.read();
+    return juce::Array<Utils::MidiNote>(heldNotes.notes.data(), heldNotes.size);
+  }
   std::vector<ParamCandidate*> getActiveCandidates();
   Utils::PitchClass getLastPitchClass() { return mLastPitchClass; }
 
+  // Number of threads voices are rendered on including the audio thread, 1 renders everything serially on the audio thread.
+  // Live playback uses at most MAX_RENDER_THREADS. Offline quality bounces default to every core, up to one thread per voice, and
+  // setting this while in one overrides that for bounces only. Call from the message thread, processing is suspended while the
+  // workers are swapped.
+  void setNumRenderThreads(int numThreads);
+  int getNumRenderThreads() const { return mRenderPool.getNumThreads(); }
+  // Host is bouncing offline and the engine is set to render those at the highest quality
+  bool isOfflineQuality() const { return isNonRealtime() && mParameters.engine.offlineQuality.load(); }
+  // The source and all its decimated levels are ready, from here on grains read exactly what they would in a full render
+  bool isSourceReady() const { return mSourcePyramid.isComplete(); }
+  // Smoothed proportion of the block deadline processBlock has been taking
+  double getProcessLoad() const { return mLoadGovernor.getLoad(); }
+  // Per stage timings and voice, grain and dropped grain counts of the last blocks, safe to call from any thread
+  PerfCounters::Snapshot getPerfSnapshot() const { return mPerf.getSnapshot(); }
+
   // Reference tone control
   void startReferenceTone(Utils::PitchClass pitchClass) {
     mReferenceTone.setFrequency(juce::MidiMessage::getMidiNoteInHertz(60 + pitchClass));
@@ -113,35 +150,26 @@ class GranularSynth : public juce::AudioProcessor, juce::MidiKeyboardState::List
   }
   void stopReferenceTone() { mReferenceTone.setAmplitude(0.0f); }
 
- private:
-  // DSP constants
+  // Spectrogram analysis
   static constexpr auto FFT_SIZE = 4096;
   static constexpr auto HOP_SIZE = 4096;  // Larger because don't need high resolution for spectrogram
-  static constexpr double DEFAULT_BPM = 120.0f;
+
+ private:
   // Param bounds
   static constexpr float MIN_RATE_RATIO = .25f;
   static constexpr float MAX_RATE_RATIO = 1.0f;
   static constexpr float MIN_CANDIDATE_SALIENCE = 0.5f;
-  static constexpr int MAX_GRAINS = 20;  // Max grains active at once
-  static constexpr double INVALID_SAMPLE_RATE = -1.0;  // Max grains active at once
-
-  typedef struct GrainNote {
-    Utils::PitchClass pitchClass;
-    float velocity;
-    int removeTs = -1; // Timestamp when note is released
-    std::array<Utils::EnvelopeADSR, NUM_GENERATORS> genAmpEnvs;
-    std::array<juce::Array<Grain>, NUM_GENERATORS> genGrains;  // Active grains for note per generator
-    std::array<float, NUM_GENERATORS> grainTriggers;           // Keeps track of triggering grains from each generator
-    GrainNote(Utils::PitchClass pitchClass_, float velocity_, Utils::EnvelopeADSR ampEnv)
-        : pitchClass(pitchClass_), velocity(velocity_) {
-      // Initialize grain triggering timestamps
-      grainTriggers.fill(-1.0f);  // Trigger first set of grains right away
-      for (size_t i = 0; i < NUM_GENERATORS; ++i) {
-        genGrains[i].ensureStorageAllocated(MAX_GRAINS);
-        genAmpEnvs[i].noteOn(ampEnv.noteOnTs);  // Set note on for each position as well
-      }
-    }
-  } GrainNote;
+  // Room for every voice to have all its generators full of grains
+  static constexpr int GRAIN_POOL_SIZE = VoicePool::MAX_VOICES * NUM_GENERATORS * GrainList::MAX_GRAINS;
+  static constexpr int MAX_RENDER_THREADS = 8;  // Live playback only, offline bounces can use up to one per voice
+  static constexpr int MAX_OVERSAMPLING = 4;
+  static constexpr int MAX_OUTPUT_CHANNELS = 2;  // Mono or stereo, see isBusesLayoutSupported()
+  static constexpr int UI_MIDI_CHANNEL = 1;  // Channel notes from the on-screen keyboard are sent out on
+  static constexpr size_t UI_MIDI_OUT_BYTES = 4096;
+  static constexpr int MIN_PARALLEL_VOICES = 4;  // Fewer voices than this isn't worth waking up the workers for
+  static constexpr double STEAL_FADE_SEC = 0.005;  // How long a stolen voice takes to fade out
+  static constexpr float STEAL_LEVEL_STEPS = 20.0f;  // Voices within 1/20th of each other's level count as just as loud
+  static constexpr double INVALID_SAMPLE_RATE = -1.0;  // Until prepareToPlay gives the real one
 
   // DSP-preprocessing
   Fft mFft;
@@ -150,9 +178,12 @@ class GranularSynth : public juce::AudioProcessor, juce::MidiKeyboardState::List
   // Bookkeeping
   juce::AudioBuffer<float> mInputBuffer;  // incoming buffer from file or other source
   juce::AudioBuffer<float> mAudioBuffer;  // final buffer used for actual synth
+  SourcePyramid mSourcePyramid;           // band-limited octaves of mAudioBuffer for transposing grains up
   std::array<Utils::SpecBuffer*, ParamUI::SpecType::COUNT> mProcessedSpecs;
   double mSampleRate = INVALID_SAMPLE_RATE;
-  juce::MidiKeyboardState mKeyboardState;
+  Utils::NoteEventFifo mUiNoteEvents;
+  juce::MidiBuffer mUiMidiOut;  // Notes from the on-screen keyboard merged with the host's midi, sized in prepareToPlay
+  std::bitset<128> mMidiNotesOn;  // Which midi note numbers are currently held
   juce::AudioFormatManager mFormatManager;
   bool mNeedsResample = false;
 
@@ -161,21 +192,94 @@ class GranularSynth : public juce::AudioProcessor, juce::MidiKeyboardState::List
 
   // Grain control
   long mTotalSamps;
-  juce::OwnedArray<GrainNote, juce::CriticalSection> mActiveNotes;
+  VoicePool mVoices;
+  GrainScheduler mScheduler;  // Next grain trigger of every generator of every active voice
+  GrainPool mGrainPool;
+  // Scratch buffers used to render a generator's grains for a whole block, one set per render thread, sized in prepareToPlay
+  struct RenderScratch {
+    juce::AudioBuffer<float> genBuffer;
+    juce::AudioBuffer<float> noteBuffer;  // Generators of a voice using the note filter are summed here before filtering
+    juce::AudioBuffer<float> laneBuffer;  // Generators using their own filter, interleaved into FilterBank lanes
+    std::vector<float> grainScratch;
+    std::vector<float> ampEnvBuffer;  // generator gain * ADSR amplitude for each sample
+    // Time spent by this thread this block, added to mPerf once all the voices are done
+    juce::int64 renderNs = 0;
+    juce::int64 filterNs = 0;
+  };
+  std::vector<RenderScratch> mRenderScratch;
+  RenderPool mRenderPool;
+  LoadGovernor mLoadGovernor;
+  PerfCounters mPerf;
+  DeadlineRecorder mDeadlineRecorder;
+  Transport mTransport;
+  Interpolation::Quality mInterpolation = Interpolation::Quality::LINEAR;  // Picked once per block
+  juce::AudioBuffer<float> mGlobalBuffer;  // Generators of all voices using the global filter are summed here before filtering
+  juce::dsp::StateVariableTPTFilter<float> mGlobalFilter;
+  // Voices render at mRenderRate, which is mSampleRate unless oversampling an offline bounce. Timestamps (mTotalSamps, grain and
+  // note timestamps, scheduled triggers) are all in samples at this rate.
+  int mOversampling = 1;
+  double mRenderRate = 44100.0;
+  std::unique_ptr<juce::dsp::Oversampling<float>> mOversampler;  // nullptr when not oversampling
+  juce::AudioBuffer<float> mOversampledBuffer;  // Refers to the oversampler's buffer while a sub-block renders, owns nothing
+  int mLiveRenderThreads = 1;
+  int mOfflineRenderThreads = 0;  // 0 uses every core
 
   Utils::PitchClass mLastPitchClass;
-  // Holds all the notes being played. The synth is the only class who will write to it so no need to worrying about multiple
-  // threads writing to it.
+  // Holds all the notes being played in the order they were pressed. Only the audio thread touches mHeldNotes and publishes a copy
+  // to mHeldNotesSnapshot for the UI whenever it changes.
   // Currently the difference between "midiNotes" and "grainNotes" are midi is a subset mainly for the UI
-  juce::Array<Utils::MidiNote> mMidiNotes;
+  struct HeldNotes {
+    std::array<Utils::MidiNote, VoicePool::MAX_VOICES> notes;
+    int size = 0;
+  };
+  HeldNotes mHeldNotes;
+  bool mHeldNotesChanged = false;
+  Utils::DoubleBuffer<HeldNotes> mHeldNotesSnapshot;
   // Level meter source
   foleys::LevelMeterSource mMeterSource;
 
   // Parameters
   Parameters mParameters;
 
-  void handleNoteOn(juce::MidiKeyboardState* state, int midiChannel, int midiNoteNumber, float velocity) override;
-  void handleNoteOff(juce::MidiKeyboardState* state, int midiChannel, int midiNoteNumber, float velocity) override;
-  void handleGrainAddRemove(int blockSize);
+  // ts is the sample the event happens at, mTotalSamps plus its offset into the block
+  void handleMidiMessage(const juce::MidiMessage& message, long ts);
+  void handleNoteOn(int midiNoteNumber, float velocity, long ts);
+  void handleNoteOff(int midiNoteNumber, long ts);
+  // Starts the release of every generator of the voice at ts
+  void releaseVoice(GrainNote& gNote, long ts);
+  // Gives the voice, its grains and its triggers back right away
+  void retireVoice(GrainNote& gNote);
+  // Picks the sounding voice that will be missed the least, or if fading is true the voice that is closest to done fading
+  GrainNote* findVoiceToSteal(bool fading);
+  // Starts every grain due in [mTotalSamps, mTotalSamps + numSamples) at its exact timestamp
+  void triggerGrains(int numSamples);
+  // Returns the timestamp the generator should trigger again at
+  double addGrain(GrainNote& gNote, size_t genIdx, long trigTs);
+  void removeExpiredGrains();
+  // Voices rendered in a single sub-block, shared with the render threads
+  struct RenderJobs {
+    GranularSynth* synth;
+    std::array<GrainNote*, VoicePool::MAX_VOICES> voices;
+    int numVoices;
+    int numChannels;
+    int numSamples;
+  };
+  static void renderVoiceJob(void* context, int job, int thread);
+  // Renders the next numSamples of a voice into its own buffers
+  void renderVoice(GrainNote& gNote, RenderScratch& scratch, int numChannels, int numSamples);
+  void prepareRenderScratch();
+  // Render threads for the mode the synth is in
+  int getTargetRenderThreads() const;
+  // Fills in a snapshot of the block that just went over for the deadline log, skipped if the log is behind
+  void recordDeadlineMiss(int numSamples);
+  // Sets the filter to the resolved params and runs it over the first numSamples of samples
+  static void applyFilter(juce::dsp::StateVariableTPTFilter<float>& filter, const ParamGenResolved& params,
+                          juce::AudioBuffer<float>& samples, int numChannels, int numSamples);
+  static void addToBuffer(const juce::AudioBuffer<float>& source, juce::AudioBuffer<float>& dest, int destStartSample,
+                          int numChannels, int numSamples);
+  // Brings a sub-block of the output up to the render rate and points mOversampledBuffer at it for the voices to be added to, then
+  // brings it back down into the same samples of the output
+  void upsampleOutput(juce::AudioBuffer<float>& buffer, int startSample, int numChannels, int numSamples);
+  void downsampleOutput(juce::AudioBuffer<float>& buffer, int startSample, int numChannels, int numSamples);
   void createCandidates(juce::HashMap<Utils::PitchClass, std::vector<PitchDetector::Pitch>>& detectedPitches);
 };
@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+    Interpolation.cpp
+    Created: 18 Oct 2026 10:48:19pm
+
+  ==============================================================================
+*/
+
+#include "Interpolation.h"
+
+namespace Interpolation {
+
+namespace {
+
+constexpr int SINC_TAPS = 8;
+constexpr int SINC_PHASES = 512;  // Fractional positions a tap set is stored for, the closest one is used
+// Lower cutoffs for reading faster than real time, which would otherwise alias. Index with getSincBand().
+constexpr int SINC_BANDS = 4;
+constexpr float SINC_BAND_CUTOFF[SINC_BANDS] = {0.9f, 0.72f, 0.6f, 0.45f};
+
+/**
+ * Windowed sinc polyphase table, taps for phase p of band b start at coeffs[b][p]. Built once when the plugin is loaded so the audio
+ * thread never has to.
+ */
+struct SincTable {
+  SincTable() {
+    for (int band = 0; band < SINC_BANDS; ++band) {
+      const double cutoff = SINC_BAND_CUTOFF[band];
+      for (int phase = 0; phase <= SINC_PHASES; ++phase) {
+        const double frac = static_cast<double>(phase) / SINC_PHASES;
+        double sum = 0.0;
+        std::array<double, SINC_TAPS> taps;
+        for (int t = 0; t < SINC_TAPS; ++t) {
+          // Distance from the read position to tap t, taps start 3 samples before the integer position
+          const double x = static_cast<double>(t - getTapsBefore(Quality::SINC)) - frac;
+          const double sinc = (x == 0.0) ? 1.0 : std::sin(juce::MathConstants<double>::pi * cutoff * x) /
+                                                     (juce::MathConstants<double>::pi * cutoff * x);
+          // Blackman window over the 8 tap span
+          const double w = (x + SINC_TAPS / 2.0) / SINC_TAPS;
+          const double window = (w <= 0.0 || w >= 1.0) ? 0.0
+                                                       : 0.42 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * w) +
+                                                             0.08 * std::cos(2.0 * juce::MathConstants<double>::twoPi * w);
+          taps[static_cast<size_t>(t)] = sinc * window;
+          sum += taps[static_cast<size_t>(t)];
+        }
+        // Unity gain at DC for every phase
+        for (int t = 0; t < SINC_TAPS; ++t) {
+          coeffs[band][phase][t] = static_cast<float>(taps[static_cast<size_t>(t)] / sum);
+        }
+      }
+    }
+  }
+
+  // One extra phase so a fraction rounding up to 1.0 still has taps
+  alignas(32) float coeffs[SINC_BANDS][SINC_PHASES + 1][SINC_TAPS];
+};
+
+const SincTable sincTable;
+
+int getSincBand(float increment) {
+  if (increment <= 1.0f) return 0;
+  if (increment <= 1.25f) return 1;
+  if (increment <= 1.5f) return 2;
+  return 3;
+}
+
+inline float cubic(float xm1, float x0, float x1, float x2, float t) {
+  // 4 point, 3rd order Hermite (Catmull-Rom)
+  const float c1 = 0.5f * (x1 - xm1);
+  const float c2 = xm1 - 2.5f * x0 + 2.0f * x1 - 0.5f * x2;
+  const float c3 = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+  return ((c3 * t + c2) * t + c1) * t + x0;
+}
+
+// The read position, fraction and sinc taps are worked out once per output sample and shared by every channel
+template <int NUM_CHANNELS>
+void processChannels(Quality quality, const float* const* src, float offset, float increment, float* const* dest,
+                     int numSamples) {
+  switch (quality) {
+    case Quality::CUBIC:
+      for (int i = 0; i < numSamples; ++i) {
+        const float phase = offset + static_cast<float>(i) * increment;
+        const int idx = static_cast<int>(phase);
+        const float rem = phase - static_cast<float>(idx);
+        for (int ch = 0; ch < NUM_CHANNELS; ++ch) {
+          const float* x = src[ch] + idx;
+          dest[ch][i] = cubic(x[-1], x[0], x[1], x[2], rem);
+        }
+      }
+      break;
+    case Quality::SINC: {
+      const float(*coeffs)[SINC_TAPS] = sincTable.coeffs[getSincBand(increment)];
+      for (int i = 0; i < numSamples; ++i) {
+        const float phase = offset + static_cast<float>(i) * increment;
+        const int idx = static_cast<int>(phase);
+        const float* c = coeffs[static_cast<int>((phase - static_cast<float>(idx)) * SINC_PHASES + 0.5f)];
+        for (int ch = 0; ch < NUM_CHANNELS; ++ch) {
+          const float* x = src[ch] + idx - getTapsBefore(Quality::SINC);
+          float sum = 0.0f;
+          for (int t = 0; t < SINC_TAPS; ++t) {
+            sum += x[t] * c[t];
+          }
+          dest[ch][i] = sum;
+        }
+      }
+      break;
+    }
+    default:
+      for (int i = 0; i < numSamples; ++i) {
+        const float phase = offset + static_cast<float>(i) * increment;
+        const int idx = static_cast<int>(phase);
+        const float rem = phase - static_cast<float>(idx);
+        for (int ch = 0; ch < NUM_CHANNELS; ++ch) {
+          const float* x = src[ch];
+          dest[ch][i] = x[idx] + rem * (x[idx + 1] - x[idx]);
+        }
+      }
+      break;
+  }
+}
+
+}  // namespace
+
+void process(Quality quality, const float* src, float offset, float increment, float* dest, int numSamples) {
+  processChannels<1>(quality, &src, offset, increment, &dest, numSamples);
+}
+
+void processStereo(Quality quality, const float* const* src, float offset, float increment, float* const* dest, int numSamples) {
+  processChannels<2>(quality, src, offset, increment, dest, numSamples);
+}
+
+float processWrapped(Quality quality, const float* src, int numSrcSamples, double pos, float increment) {
+  const int idx = static_cast<int>(std::floor(pos));
+  const float rem = static_cast<float>(pos - idx);
+  auto at = [src, numSrcSamples](int i) { return src[((i % numSrcSamples) + numSrcSamples) % numSrcSamples]; };
+  switch (quality) {
+    case Quality::CUBIC:
+      return cubic(at(idx - 1), at(idx), at(idx + 1), at(idx + 2), rem);
+    case Quality::SINC: {
+      const float* c = sincTable.coeffs[getSincBand(increment)][static_cast<int>(rem * SINC_PHASES + 0.5f)];
+      float sum = 0.0f;
+      for (int t = 0; t < SINC_TAPS; ++t) {
+        sum += at(idx - getTapsBefore(Quality::SINC) + t) * c[t];
+      }
+      return sum;
+    }
+    default:
+      return at(idx) + rem * (at(idx + 1) - at(idx));
+  }
+}
+
+}  // namespace Interpolation
@@ -0,0 +1,39 @@
+/*
+  ==============================================================================
+
+    Interpolation.h
+    Created: 18 Oct 2026 10:48:19pm
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <juce_core/juce_core.h>
+
+/**
+ * Fractional delay interpolators used to read grains out of the source buffer at any playback rate. Each works on a whole block of
+ * output samples at a time with fixed size tap loops so the compiler can vectorize them.
+ */
+namespace Interpolation {
+
+enum class Quality { LINEAR = 0, CUBIC, SINC, COUNT };
+static juce::Array<juce::String> QUALITY_NAMES{"linear", "cubic", "sinc"};
+
+// Number of source samples needed before and after the integer read position
+constexpr int getTapsBefore(Quality quality) { return quality == Quality::SINC ? 3 : (quality == Quality::CUBIC ? 1 : 0); }
+constexpr int getTapsAfter(Quality quality) { return quality == Quality::SINC ? 4 : (quality == Quality::CUBIC ? 2 : 1); }
+
+/**
+ * @brief Reads numSamples samples, the first at src[offset] and each after increment further along
+ *
+ * The caller guarantees every tap is inside the source, so from getTapsBefore() samples before src up to getTapsAfter() samples past
+ * the last integer read position.
+ */
+void process(Quality quality, const float* src, float offset, float increment, float* dest, int numSamples);
+// Same as process() for two channels read at the same positions, src and dest each hold a left and right pointer
+void processStereo(Quality quality, const float* const* src, float offset, float increment, float* const* dest, int numSamples);
+
+// Reads a single sample at pos, treating the source as circular. Slow, only for the few samples near the edges of the source.
+float processWrapped(Quality quality, const float* src, int numSrcSamples, double pos, float increment);
+
+}  // namespace Interpolation
@@ -0,0 +1,24 @@
+/*
+  ==============================================================================
+
+    LoadGovernor.cpp
+    Created: 18 Oct 2026 9:37:02pm
+
+  ==============================================================================
+*/
+
+#include "LoadGovernor.h"
+
+void LoadGovernor::prepare(double sampleRate, int samplesPerBlock) {
+  mLoadMeasurer.reset(sampleRate, samplesPerBlock);
+  mScale = 1.0f;
+}
+
+void LoadGovernor::update(float threshold, bool enabled) {
+  const double load = mLoadMeasurer.getLoadAsProportion();
+  if (enabled && load > threshold) {
+    mScale = juce::jmax(MIN_SCALE, mScale - SCALE_DOWN_STEP);
+  } else if (!enabled || load < threshold - HYSTERESIS) {
+    mScale = juce::jmin(1.0f, mScale + SCALE_UP_STEP);
+  }
+}
@@ -0,0 +1,53 @@
+/*
+  ==============================================================================
+
+    LoadGovernor.h
+    Created: 18 Oct 2026 9:37:02pm
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/**
+ * Watches how much of the block deadline processBlock is using and eases the synth's workload down when it gets close, then back
+ * up once there is headroom again. Everything it hands out is a simple scale so the synth decides what "less work" means.
+ */
+class LoadGovernor {
+ public:
+  void prepare(double sampleRate, int samplesPerBlock);
+
+  // Time a block with a juce::AudioProcessLoadMeasurer::ScopedTimer on this
+  juce::AudioProcessLoadMeasurer& getLoadMeasurer() { return mLoadMeasurer; }
+
+  /**
+   * @brief Moves the workload scale a step based on the load of the last blocks, to be called once at the start of each block
+   *
+   * @param threshold Proportion of the block deadline (0-1) to keep the load under
+   * @param enabled If false the scale is brought back up to full workload
+   */
+  void update(float threshold, bool enabled);
+
+  // 1.0 when running everything as asked down to MIN_SCALE under heavy load
+  float getScale() const { return mScale; }
+  // Multiplier for the time between grain triggers, so fewer grains are started when under load
+  float getIntervalScale() const { return 1.0f / mScale; }
+  // Max grains a single generator can have playing at once
+  int getMaxGrains(int maxGrains) const { return juce::jmax(1, juce::roundToInt(maxGrains * mScale)); }
+  // Generators with their own filter share the note filter of their voice instead
+  bool shouldShareFilters() const { return mScale < SHARE_FILTERS_SCALE; }
+  double getLoad() const { return mLoadMeasurer.getLoadAsProportion(); }
+
+ private:
+  static constexpr float MIN_SCALE = 0.25f;
+  static constexpr float SHARE_FILTERS_SCALE = 0.6f;
+  // Backs off quicker than it recovers so it doesn't bounce right back into overload
+  static constexpr float SCALE_DOWN_STEP = 0.05f;
+  static constexpr float SCALE_UP_STEP = 0.01f;
+  // Load has to drop this far under the threshold before the workload goes back up
+  static constexpr float HYSTERESIS = 0.15f;
+
+  juce::AudioProcessLoadMeasurer mLoadMeasurer;
+  float mScale = 1.0f;
+};
@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    PerfCounters.cpp
+    Created: 19 Oct 2026 5:47:19am
+
+  ==============================================================================
+*/
+
+#include "PerfCounters.h"
+
+void PerfCounters::prepare(int grainCapacity) {
+  mBlock = {};
+  mBlockDrops = 0;
+  mHistory = {};
+  mNext = 0;
+  mStageSums = {};
+  mBlockSum = 0;
+  mDeadlineSum = 0;
+  mWorking = {};
+  mWorking.grainsPerBin = juce::jmax(1, (grainCapacity + NUM_GRAIN_BINS) / NUM_GRAIN_BINS);
+  mSnapshot.write(mWorking);
+}
+
+void PerfCounters::beginBlock(int numSamples, double sampleRate) {
+  mBlock = {};
+  mBlock.deadlineNs = static_cast<juce::int64>(1e9 * numSamples / sampleRate);
+  mBlockDrops = 0;
+}
+
+int PerfCounters::getDropBin(int drops) {
+  int bin = 0;
+  while (drops > 0 && bin < NUM_DROP_BINS - 1) {
+    drops >>= 1;
+    ++bin;
+  }
+  return bin;
+}
+
+void PerfCounters::endBlock(StageTimer& blockTimer, int numVoices, int numGrains) {
+  blockTimer.tock();
+  mBlock.blockNs = blockTimer.duration().count();
+  mBlock.voiceBin = juce::jlimit(0, NUM_VOICE_BINS - 1, numVoices);
+  mBlock.grainBin = juce::jlimit(0, NUM_GRAIN_BINS - 1, numGrains / mWorking.grainsPerBin);
+  mBlock.dropBin = getDropBin(mBlockDrops);
+  mWorking.totalDrops += mBlockDrops;
+
+  // The oldest block leaves the window as this one comes in
+  BlockRecord& slot = mHistory[static_cast<size_t>(mNext)];
+  if (mWorking.numBlocks == HISTORY_BLOCKS) {
+    for (int stage = 0; stage < NUM_STAGES; ++stage) mStageSums[stage] -= slot.stageNs[stage];
+    mBlockSum -= slot.blockNs;
+    mDeadlineSum -= slot.deadlineNs;
+    --mWorking.voices[slot.voiceBin];
+    --mWorking.grains[slot.grainBin];
+    --mWorking.drops[slot.dropBin];
+  } else {
+    ++mWorking.numBlocks;
+  }
+  slot = mBlock;
+  for (int stage = 0; stage < NUM_STAGES; ++stage) mStageSums[stage] += slot.stageNs[stage];
+  mBlockSum += slot.blockNs;
+  mDeadlineSum += slot.deadlineNs;
+  ++mWorking.voices[slot.voiceBin];
+  ++mWorking.grains[slot.grainBin];
+  ++mWorking.drops[slot.dropBin];
+  mNext = (mNext + 1) % HISTORY_BLOCKS;
+
+  const float usPerBlock = 1e-3f / static_cast<float>(mWorking.numBlocks);
+  for (int stage = 0; stage < NUM_STAGES; ++stage) mWorking.stageUs[stage] = static_cast<float>(mStageSums[stage]) * usPerBlock;
+  mWorking.blockUs = static_cast<float>(mBlockSum) * usPerBlock;
+  mWorking.deadlineUs = static_cast<float>(mDeadlineSum) * usPerBlock;
+  juce::int64 maxBlockNs = 0;
+  for (int i = 0; i < mWorking.numBlocks; ++i) maxBlockNs = juce::jmax(maxBlockNs, mHistory[static_cast<size_t>(i)].blockNs);
+  mWorking.maxBlockUs = static_cast<float>(maxBlockNs) * 1e-3f;
+  mSnapshot.write(mWorking);
+}
@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    PerfCounters.h
+    Created: 19 Oct 2026 5:47:19am
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <juce_core/juce_core.h>
+#include <array>
+#include <chrono>
+#include "Utils/DoubleBuffer.h"
+#include "Utils/Timer.h"
+
+/**
+ * Where processBlock's time goes and how busy the synth was, over the last HISTORY_BLOCKS blocks. Only the audio thread writes to
+ * it, at the end of every block it publishes a snapshot the editor can read from any thread without locking. Stage times are CPU
+ * time summed over every render thread, so with render workers they can add up to more than the block took.
+ */
+class PerfCounters {
+ public:
+  enum Stage { MIDI = 0, SCHEDULING, RENDER, FILTER, METER, NUM_STAGES };
+  static inline const juce::StringArray STAGE_NAMES{"MIDI", "Scheduling", "Render", "Filter", "Meter"};
+
+  static constexpr int HISTORY_BLOCKS = 256;
+  static constexpr int NUM_VOICE_BINS = 33;  // One for each number of voices, up to VoicePool::MAX_VOICES
+  static constexpr int NUM_GRAIN_BINS = 16;
+  static constexpr int NUM_DROP_BINS = 6;  // 0, 1, 2-3, 4-7, 8-15 and 16 or more grains dropped in a block
+
+  using StageTimer = Utils::Timer<std::chrono::nanoseconds>;
+
+  struct Snapshot {
+    int numBlocks = 0;  // Blocks in the window, the histograms add up to this
+    // Means per block over the window
+    std::array<float, NUM_STAGES> stageUs = {};
+    float blockUs = 0.0f;
+    float deadlineUs = 0.0f;
+    float maxBlockUs = 0.0f;
+    // Number of blocks that ended with that many active voices, active grains, or that dropped that many grains at the cap
+    std::array<int, NUM_VOICE_BINS> voices = {};
+    std::array<int, NUM_GRAIN_BINS> grains = {};
+    std::array<int, NUM_DROP_BINS> drops = {};
+    int grainsPerBin = 1;
+    juce::int64 totalDrops = 0;  // Since prepare()
+  };
+
+  struct BlockTimes {
+    std::array<juce::int64, NUM_STAGES> stageNs;
+    juce::int64 blockNs;
+    juce::int64 deadlineNs;
+  };
+
+  // Clears the window. Not real-time safe.
+  void prepare(int grainCapacity);
+
+  // Audio thread only
+  void beginBlock(int numSamples, double sampleRate);
+  // Nanoseconds since the timer was last ticked, then ticks it again so the next stage starts timing from here
+  static juce::int64 lap(StageTimer& timer) {
+    timer.tock();
+    const juce::int64 ns = timer.duration().count();
+    timer.tick();
+    return ns;
+  }
+  void lap(Stage stage, StageTimer& timer) { mBlock.stageNs[stage] += lap(timer); }
+  void addNanoseconds(Stage stage, juce::int64 ns) { mBlock.stageNs[stage] += ns; }
+  void addDroppedGrain() { ++mBlockDrops; }
+  // blockTimer was ticked at the start of the block
+  void endBlock(StageTimer& blockTimer, int numVoices, int numGrains);
+  // Times of the block endBlock() was last called for, until the next beginBlock()
+  const BlockTimes& getLastBlock() const { return mBlock; }
+
+  // Any thread
+  Snapshot getSnapshot() const { return mSnapshot.read(); }
+
+ private:
+  struct BlockRecord : BlockTimes {
+    int voiceBin;
+    int grainBin;
+    int dropBin;
+  };
+
+  static int getDropBin(int drops);
+
+  BlockRecord mBlock = {};  // Block being timed
+  int mBlockDrops = 0;
+  std::array<BlockRecord, HISTORY_BLOCKS> mHistory = {};
+  int mNext = 0;
+  // Running sums of what is in mHistory
+  std::array<juce::int64, NUM_STAGES> mStageSums = {};
+  juce::int64 mBlockSum = 0;
+  juce::int64 mDeadlineSum = 0;
+  Snapshot mWorking;  // Histograms are kept up to date in here and the rest filled in before publishing
+  Utils::DoubleBuffer<Snapshot> mSnapshot;
+};
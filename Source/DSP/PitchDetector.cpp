@@ -37,6 +37,12 @@ void PitchDetector::process(const juce::AudioBuffer<float>* audioBuffer, double
   mFft.process(audioBuffer);
 }
 
+void PitchDetector::computeSpectrum(const juce::AudioBuffer<float>* audioBuffer, double sampleRate) {
+  cancelProcessing();
+  mSampleRate = sampleRate;
+  mFft.processSync(audioBuffer);
+}
+
 void PitchDetector::cancelProcessing() {
   mFft.stopThread(4000);
   stopThread(4000);
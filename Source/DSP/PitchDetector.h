@@ -64,6 +64,17 @@ class PitchDetector : juce::Thread {
   // Clear any data not used after lifetime of run()
   void clear();
 
+  // The stages of process() one at a time on the calling thread, none of the callbacks are called. For offline tools that need to
+  // time or check each stage on its own.
+  void computeSpectrum(const juce::AudioBuffer<float>* audioBuffer, double sampleRate);
+  bool computeHPCP();
+  bool segmentPitches();
+  void getSegmentedPitchBuffer();
+  const Utils::SpecBuffer& getSpectrum() { return mFft.getSpectrum(); }
+  const Utils::SpecBuffer& getHPCP() const { return mHPCP; }
+  PitchMap& getPitches() { return mPitchMap; }
+  const Utils::SpecBuffer& getSegmentedPitches() const { return mSegmentedPitches; }
+
  private:
   // FFT
   static constexpr int FFT_SIZE = 4096;
@@ -133,9 +144,6 @@ class PitchDetector : juce::Thread {
   // Hashmap of detected pitches
   PitchMap mPitchMap;
 
-  bool computeHPCP();
-  bool segmentPitches();
-  void getSegmentedPitchBuffer();
   bool hasBetterCandidateAhead(int startFrame, float target,
                                float deviation);  // True if a closer target is ahead
   Utils::PitchClass getPitchClass(float binNum);  // Finds the closest pitch class
@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    RenderPool.cpp
+    Created: 18 Oct 2026 8:22:35pm
+
+  ==============================================================================
+*/
+
+#include "RenderPool.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "Utils/RtCheck.h"
+
+void RenderPool::setNumWorkers(int numWorkers) {
+  for (Worker* worker : mWorkers) {
+    worker->signalThreadShouldExit();
+  }
+  wakeWorkers();
+  mWorkers.clear();  // Waits for each to exit
+
+  for (int i = 0; i < numWorkers; ++i) {
+    Worker* worker = mWorkers.add(new Worker(*this, i + 1));
+    if (!worker->startRealtimeThread(juce::Thread::RealtimeOptions{})) {
+      // Still better than nothing if the OS won't give realtime priority
+      worker->startThread(juce::Thread::Priority::highest);
+    }
+  }
+}
+
+void RenderPool::run(int numJobs, JobFunction function, void* context) {
+  jassert(numJobs <= MAX_JOBS);
+  if (numJobs <= 0) return;
+
+  // All jobs of the last batch are done at this point, so nothing else is writing to these
+  mFunction = function;
+  mContext = context;
+  mJobsDone.store(0, std::memory_order_relaxed);
+  const juce::uint64 batch = (mClaim.load(std::memory_order_relaxed) >> 32) + 1;
+  mClaim.store((batch << 32) | (static_cast<juce::uint64>(numJobs) << 16), std::memory_order_release);
+  wakeWorkers();
+
+  while (runNextJob(0)) {
+  }
+  // Others are finishing up the jobs they claimed
+  while (mJobsDone.load(std::memory_order_acquire) < numJobs) {
+  }
+}
+
+bool RenderPool::runNextJob(int thread) {
+  juce::uint64 claim = mClaim.load(std::memory_order_acquire);
+  while (true) {
+    const int job = static_cast<int>(claim & 0xFFFF);
+    const int numJobs = static_cast<int>((claim >> 16) & 0xFFFF);
+    if (job >= numJobs) return false;
+    if (mClaim.compare_exchange_weak(claim, claim + 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+      // Workers are doing audio work for as long as the job runs, the calling thread already is
+      Utils::RtCheck::ScopedAudioThread rtCheck;
+      mFunction(mContext, job, thread);
+      mJobsDone.fetch_add(1, std::memory_order_release);
+      return true;
+    }
+  }
+}
+
+void RenderPool::wakeWorkers() {
+  // Atomic notify goes straight to the OS wait primitive (futex, ulock, WaitOnAddress) without taking a lock, and does nothing
+  // when no worker is waiting
+  mWakeCount.fetch_add(1);
+  mWakeCount.notify_all();
+}
+
+void RenderPool::Worker::run() {
+  // Same as the audio thread, filter tails decaying into denormals would otherwise slow the workers right down
+  juce::ScopedNoDenormals noDenormals;
+  int idleIterations = 0;
+  while (!threadShouldExit()) {
+    if (mPool.runNextJob(mIndex)) {
+      idleIterations = 0;
+      continue;
+    }
+    // Sub-blocks of the same block come in right after each other, so spin a little before going to sleep
+    if (++idleIterations < SPIN_ITERATIONS) continue;
+
+    // Read before checking for work one last time, a batch published after that check changes it and the wait returns at once
+    const juce::uint32 wakeCount = mPool.mWakeCount.load();
+    if (threadShouldExit() || mPool.runNextJob(mIndex)) {
+      idleIterations = 0;
+      continue;
+    }
+    mPool.mWakeCount.wait(wakeCount);
+    idleIterations = 0;
+  }
+}
@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    RenderPool.h
+    Created: 18 Oct 2026 8:22:35pm
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <juce_core/juce_core.h>
+
+/**
+ * A small pool of realtime priority worker threads the audio thread can hand a batch of independent jobs to. The calling thread
+ * works on the batch as well and then spins until every job is done, so it never blocks on an OS primitive. A batch is published
+ * and claimed through a single atomic word, workers that are still waking up just leave their share to the others. Idle workers
+ * sleep on an atomic wait that publishing a batch notifies, which never takes a lock on the audio thread.
+ */
+class RenderPool {
+ public:
+  // context is whatever was passed to run(), thread is 0 for the calling thread and 1..getNumThreads() for the workers
+  using JobFunction = void (*)(void* context, int job, int thread);
+
+  RenderPool() = default;
+  ~RenderPool() { setNumWorkers(0); }
+
+  // Starts or stops workers, not real-time safe and must not be called while run() is in progress
+  void setNumWorkers(int numWorkers);
+  int getNumWorkers() const { return mWorkers.size(); }
+  // Number of threads that can be running jobs, including the calling thread
+  int getNumThreads() const { return mWorkers.size() + 1; }
+
+  // Runs function for every job in [0, numJobs) and returns once all of them are done
+  void run(int numJobs, JobFunction function, void* context);
+
+ private:
+  static constexpr int MAX_JOBS = 0xFFFF;
+  // How many times an idle worker checks for work before it sleeps until the next batch
+  static constexpr int SPIN_ITERATIONS = 2000;
+
+  class Worker : public juce::Thread {
+   public:
+    Worker(RenderPool& pool, int index) : juce::Thread("gRainbow render " + juce::String(index)), mPool(pool), mIndex(index) {}
+    void run() override;
+
+   private:
+    RenderPool& mPool;
+    const int mIndex;
+  };
+
+  // Claims and runs a single job of the current batch, returns false if there was nothing left to claim
+  bool runNextJob(int thread);
+  // Wakes the workers sleeping between batches without blocking, safe to call from the audio thread
+  void wakeWorkers();
+
+  // (batch << 32) | (numJobs << 16) | next job, so a job index can't be claimed against another batch's job count
+  std::atomic<juce::uint64> mClaim{0};
+  std::atomic<int> mJobsDone{0};
+  std::atomic<juce::uint32> mWakeCount{0};  // Goes up with every batch, idle workers wait for it to change
+  JobFunction mFunction = nullptr;
+  void* mContext = nullptr;
+  juce::OwnedArray<Worker> mWorkers;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderPool)
+};
@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    SourcePyramid.cpp
+    Created: 18 Oct 2026 11:48:15pm
+
+  ==============================================================================
+*/
+
+#include "SourcePyramid.h"
+
+SourcePyramid::SourcePyramid(const juce::AudioBuffer<float>& source) : juce::Thread("source pyramid thread"), mSource(source) {
+  // Blackman windowed sinc, normalized to unity gain at DC
+  double sum = 0.0;
+  std::array<double, FILTER_TAPS> taps;
+  for (int i = 0; i < FILTER_TAPS; ++i) {
+    const double x = static_cast<double>(i - FILTER_HALF);
+    const double sinc = (i == FILTER_HALF) ? 2.0 * FILTER_CUTOFF
+                                           : std::sin(juce::MathConstants<double>::twoPi * FILTER_CUTOFF * x) /
+                                                 (juce::MathConstants<double>::pi * x);
+    const double phase = juce::MathConstants<double>::twoPi * static_cast<double>(i) / static_cast<double>(FILTER_TAPS - 1);
+    const double window = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+    taps[i] = sinc * window;
+    sum += taps[i];
+  }
+  for (int i = 0; i < FILTER_TAPS; ++i) {
+    mFilter[i] = static_cast<float>(taps[i] / sum);
+  }
+}
+
+SourcePyramid::~SourcePyramid() { clear(); }
+
+void SourcePyramid::run() {
+  const int numChannels = getNumChannels();
+  for (int level = 1; level < MAX_LEVELS && !threadShouldExit(); ++level) {
+    const int numInput = getNumSamples(level - 1);
+    const int numOutput = (numInput + 1) / 2;
+    if (numOutput < MIN_LEVEL_SIZE) break;
+
+    for (int ch = 0; ch < numChannels && !threadShouldExit(); ++ch) {
+      const float* input = getReadPointer(level - 1, ch);
+      // Nothing reads this level until it is published below
+      std::vector<float>& output = mLevels[level][ch];
+      output.resize(numOutput);
+      for (int j = 0; j < numOutput && !threadShouldExit(); ++j) {
+        // Grains wrap around the end of the buffer, so the filter does too
+        const int center = j * 2;
+        float acc = 0.0f;
+        if (center >= FILTER_HALF && center + FILTER_HALF < numInput) {
+          const float* x = input + center - FILTER_HALF;
+          for (int t = 0; t < FILTER_TAPS; ++t) acc += mFilter[t] * x[t];
+        } else {
+          for (int t = 0; t < FILTER_TAPS; ++t) {
+            int idx = (center + t - FILTER_HALF) % numInput;
+            if (idx < 0) idx += numInput;
+            acc += mFilter[t] * input[idx];
+          }
+        }
+        output[j] = acc;
+      }
+    }
+    if (threadShouldExit()) return;
+    mNumReady.store(level + 1, std::memory_order_release);
+  }
+  if (!threadShouldExit()) mComplete.store(true, std::memory_order_release);
+}
+
+void SourcePyramid::build() {
+  clear();
+  if (mSource.getNumSamples() > 0) startThread();
+}
+
+void SourcePyramid::clear() {
+  stopThread(4000);
+  mComplete.store(false, std::memory_order_release);
+  mNumReady.store(1, std::memory_order_release);
+  for (std::array<std::vector<float>, MAX_CHANNELS>& level : mLevels) {
+    for (std::vector<float>& channel : level) {
+      // Levels can be large, have STD actually give the memory back
+      channel.clear();
+      channel.shrink_to_fit();
+    }
+  }
+}
@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    SourcePyramid.h
+    Created: 18 Oct 2026 11:48:15pm
+
+    Band-limited octave levels of the source buffer so transposed grains can
+    read from a copy that has nothing left above the output Nyquist
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <atomic>
+
+/**
+ * Level 0 is the source buffer itself, level k is the source low passed and decimated by 2^k. Levels are built on a background
+ * thread after a new buffer is loaded and published one at a time, so grains fall back to the highest level that is ready. Each
+ * level is half the size of the one below it, so all of them together take at most the size of the source again.
+ */
+class SourcePyramid : public juce::Thread {
+ public:
+  static constexpr int MAX_LEVELS = 5;    // source plus 4 octaves down, covering transpositions up to +4 octaves
+  static constexpr int MAX_CHANNELS = 2;  // sources with more channels are folded down to stereo when loaded
+  // Read increments up to this are left on the current level. The sinc interpolation narrows its own cutoff for them and it keeps
+  // a grain just above the original pitch from losing a whole octave of bandwidth.
+  static constexpr float MAX_LEVEL_INCREMENT = 1.25f;
+
+  explicit SourcePyramid(const juce::AudioBuffer<float>& source);
+  ~SourcePyramid();
+
+  void run() override;
+  // Drops the old levels and starts building from the current source, to be called once the source buffer was replaced
+  void build();
+  // Stops any build in progress and frees the levels
+  void clear();
+
+  // Only hands out levels once all of them are built, so what a grain reads doesn't depend on how far the build thread got
+  void setDeterministic(bool deterministic) { mDeterministic.store(deterministic, std::memory_order_relaxed); }
+  // Every level of the current source has been built
+  bool isComplete() const { return mComplete.load(std::memory_order_acquire); }
+
+  // Level to read for a grain at playback rate pbRate, only ever one that is ready
+  int getLevel(float pbRate) const {
+    if (mDeterministic.load(std::memory_order_relaxed) && !mComplete.load(std::memory_order_acquire)) return 0;
+    const int numReady = mNumReady.load(std::memory_order_acquire);
+    int level = 0;
+    while (level + 1 < numReady && pbRate / static_cast<float>(1 << level) > MAX_LEVEL_INCREMENT) level++;
+    return level;
+  }
+  int getNumChannels() const { return juce::jmin(mSource.getNumChannels(), MAX_CHANNELS); }
+  const float* getReadPointer(int level, int channel) const {
+    return (level == 0) ? mSource.getReadPointer(channel) : mLevels[level][channel].data();
+  }
+  int getNumSamples(int level) const {
+    return (level == 0) ? mSource.getNumSamples() : static_cast<int>(mLevels[level][0].size());
+  }
+
+ private:
+  // Half band low pass run before each decimation, windowed sinc with the cutoff a bit under the new Nyquist
+  static constexpr int FILTER_TAPS = 47;
+  static constexpr int FILTER_HALF = FILTER_TAPS / 2;
+  static constexpr double FILTER_CUTOFF = 0.22;  // cycles per sample of the level being decimated
+  // A level smaller than this isn't worth building
+  static constexpr int MIN_LEVEL_SIZE = FILTER_TAPS * 4;
+
+  const juce::AudioBuffer<float>& mSource;
+  std::array<float, FILTER_TAPS> mFilter;
+  // Index 0 is unused, level 0 reads the source directly
+  std::array<std::array<std::vector<float>, MAX_CHANNELS>, MAX_LEVELS> mLevels;
+  // Levels [0, mNumReady) can be read from, level 0 always can
+  std::atomic<int> mNumReady{1};
+  std::atomic<bool> mComplete{false};  // Every level that is going to be built is ready
+  std::atomic<bool> mDeterministic{false};
+};
@@ -36,6 +36,12 @@ class TransientDetector : juce::Thread {
 
   void run() override;
 
+  // The stages of process() one at a time on the calling thread without calling onTransientsUpdated, for offline tools
+  void computeSpectrum(const juce::AudioBuffer<float>* audioBuffer) { mFft.processSync(audioBuffer); }
+  void retrieveTransients();
+  const Utils::SpecBuffer& getSpectrum() { return mFft.getSpectrum(); }
+  const std::vector<Transient>& getTransients() const { return mTransients; }
+
  private:
   static constexpr auto FFT_SIZE = 1024;
   static constexpr auto HOP_SIZE = 512;
@@ -55,7 +61,6 @@ class TransientDetector : juce::Thread {
   int mAttackFrames = PARAM_ATTACK_LOCK;
 
   void updateFft();
-  void retrieveTransients();
   // Using current energy buffer and attack frame counter, determines if current
   // frame is a transient frame
   bool isTransient();
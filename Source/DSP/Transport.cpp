@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    Transport.cpp
+    Created: 19 Oct 2026 1:14:22am
+
+  ==============================================================================
+*/
+
+#include "Transport.h"
+
+void Transport::prepare(double sampleRate) {
+  mSampleRate = sampleRate;
+  mSamplesPerBeat = mSampleRate * 60.0 / mBpm;
+  mLastNumSamples = 0;
+}
+
+void Transport::update(juce::AudioPlayHead* playHead, long blockTs, int numSamples) {
+  // Runs on from the last block unless the host says otherwise
+  const double freePpq = mBlockPpq + static_cast<double>(mLastNumSamples) / mSamplesPerBeat;
+  juce::Optional<double> hostPpq;
+  juce::Optional<double> hostBarStartPpq;
+  if (playHead != nullptr) {
+    juce::Optional<juce::AudioPlayHead::PositionInfo> info = playHead->getPosition();
+    if (info) {
+      juce::Optional<double> bpm = info->getBpm();
+      if (bpm && *bpm > 0.0) mBpm = *bpm;
+      juce::Optional<juce::AudioPlayHead::TimeSignature> timeSig = info->getTimeSignature();
+      if (timeSig && timeSig->denominator > 0) {
+        mBarBeats = 4.0 * static_cast<double>(timeSig->numerator) / static_cast<double>(timeSig->denominator);
+      }
+      // A stopped host usually keeps reporting the same position, which would stop the grid too
+      if (info->getIsPlaying()) {
+        hostPpq = info->getPpqPosition();
+        hostBarStartPpq = info->getPpqPositionOfLastBarStart();
+      }
+    }
+  }
+
+  mSamplesPerBeat = mSampleRate * 60.0 / mBpm;
+  mBlockTs = blockTs;
+  mBlockPpq = hostPpq ? *hostPpq : freePpq;
+  if (hostBarStartPpq) {
+    mBarStartPpq = *hostBarStartPpq;
+  } else if (!hostPpq) {
+    // Keep the anchor within a bar of the position so it doesn't lose precision on long takes
+    mBarStartPpq += std::floor((mBlockPpq - mBarStartPpq) / mBarBeats) * mBarBeats;
+  } else {
+    mBarStartPpq = 0.0;
+  }
+  mLastNumSamples = numSamples;
+}
+
+double Transport::getNextGridTs(double ts, double gridBeats) const {
+  // Grid position of the earliest time the next grain could start, rounded up to the next line
+  const double gridPos = (getPpq(ts + 1.0) - mBarStartPpq) / gridBeats;
+  const double nextPpq = mBarStartPpq + std::ceil(gridPos) * gridBeats;
+  return static_cast<double>(mBlockTs) + (nextPpq - mBlockPpq) * mSamplesPerBeat;
+}
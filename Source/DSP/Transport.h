@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    Transport.h
+    Created: 19 Oct 2026 1:14:22am
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+
+/**
+ * One snapshot of the host's transport per block, mapped onto the synth's own sample timestamps so tempo synced grains can be
+ * placed on the host's beat grid without asking the playhead again. While the host is playing the position is taken from it every
+ * block, so a grid line can never drift away from the host's bar lines. When it is stopped (or doesn't report a position) the grid
+ * keeps running on its own at the last known tempo.
+ */
+class Transport {
+ public:
+  static constexpr double DEFAULT_BPM = 120.0;
+
+  void prepare(double sampleRate);
+
+  // Takes the snapshot for the block starting at the synth timestamp blockTs, the only place the playhead is read
+  void update(juce::AudioPlayHead* playHead, long blockTs, int numSamples);
+
+  double getBpm() const { return mBpm; }
+  double getSamplesPerBeat() const { return mSamplesPerBeat; }
+  // Length of a bar in beats (quarter notes)
+  double getBarBeats() const { return mBarBeats; }
+  // Position in beats (quarter notes) at the synth timestamp ts
+  double getPpq(double ts) const { return mBlockPpq + (ts - static_cast<double>(mBlockTs)) / mSamplesPerBeat; }
+
+  /**
+   * @brief Timestamp of the first grid line after ts, where the grid has a line every gridBeats beats starting from the last bar
+   * line. Always at least a sample after ts.
+   */
+  double getNextGridTs(double ts, double gridBeats) const;
+
+ private:
+  double mSampleRate = 44100.0;
+  double mBpm = DEFAULT_BPM;
+  double mSamplesPerBeat = 44100.0 * 60.0 / DEFAULT_BPM;
+  double mBarBeats = 4.0;
+  long mBlockTs = 0;
+  double mBlockPpq = 0.0;
+  double mBarStartPpq = 0.0;  // Where the grid is anchored
+  int mLastNumSamples = 0;    // To run the grid on when the host gives no position
+};
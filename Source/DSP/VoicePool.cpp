@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    VoicePool.cpp
+    Created: 18 Oct 2026 5:03:51pm
+
+  ==============================================================================
+*/
+
+#include "VoicePool.h"
+
+VoicePool::VoicePool() { reset(); }
+
+void VoicePool::prepare(const juce::dsp::ProcessSpec& spec) {
+  for (GrainNote& voice : mVoices) {
+    voice.genFilters.prepare(spec);
+    voice.noteFilter.prepare(spec);
+    voice.mixBuffer.setSize(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
+    voice.globalBuffer.setSize(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
+  }
+}
+
+void VoicePool::reset() {
+  mFreeHead.store(EMPTY);
+  for (int i = MAX_VOICES - 1; i >= 0; --i) {
+    mActive[static_cast<size_t>(i)].store(false);
+    // Lowest index is handed out first
+    push(static_cast<juce::uint32>(i));
+  }
+  mNumActive.store(0);
+}
+
+GrainNote* VoicePool::acquire() {
+  juce::uint64 head = mFreeHead.load(std::memory_order_acquire);
+  while (true) {
+    const juce::uint32 index = static_cast<juce::uint32>(head);
+    if (index == EMPTY) return nullptr;
+    const juce::uint32 next = mNextFree[index].load(std::memory_order_relaxed);
+    const juce::uint64 newHead = (((head >> 32) + 1) << 32) | next;
+    if (mFreeHead.compare_exchange_weak(head, newHead, std::memory_order_acq_rel, std::memory_order_acquire)) {
+      return &mVoices[index];
+    }
+  }
+}
+
+void VoicePool::activate(GrainNote* voice) {
+  mNumActive.fetch_add(1, std::memory_order_relaxed);
+  mActive[static_cast<size_t>(getIndex(voice))].store(true, std::memory_order_release);
+}
+
+void VoicePool::release(GrainNote* voice) {
+  const int index = getIndex(voice);
+  jassert(mActive[static_cast<size_t>(index)].load());
+  mActive[static_cast<size_t>(index)].store(false, std::memory_order_release);
+  mNumActive.fetch_sub(1, std::memory_order_relaxed);
+  push(static_cast<juce::uint32>(index));
+}
+
+void VoicePool::push(juce::uint32 index) {
+  juce::uint64 head = mFreeHead.load(std::memory_order_relaxed);
+  juce::uint64 newHead;
+  do {
+    mNextFree[index].store(static_cast<juce::uint32>(head), std::memory_order_relaxed);
+    newHead = (((head >> 32) + 1) << 32) | index;
+  } while (!mFreeHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+}
@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+    VoicePool.h
+    Created: 18 Oct 2026 5:03:51pm
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include "GrainPool.h"
+#include "FilterBank.h"
+#include "Parameters.h"
+#include "Utils/Utils.h"
+#include "Utils/FastRandom.h"
+#include "Utils/PitchClass.h"
+
+static_assert(FilterBank::NUM_LANES == NUM_GENERATORS, "Every generator needs its own filter lane");
+
+// A single note being played and the state of each of its generators
+struct GrainNote {
+  int midiNote = -1;
+  Utils::PitchClass pitchClass = Utils::PitchClass::NONE;
+  float velocity = 0.0f;
+  long startTs = 0;
+  long removeTs = -1;  // Timestamp when note is done releasing and gets removed
+  long stealTs = -1;   // Timestamp when the voice was stolen and started fading out
+  std::array<Utils::EnvelopeADSR, NUM_GENERATORS> genAmpEnvs;
+  std::array<GrainList, NUM_GENERATORS> genGrains;  // Active grains for note per generator, owned by the GrainPool
+  Utils::FastRandom random;  // Grain spray, seeded when the note starts
+  // Filter state belongs to the voice so notes of the same pitch class don't run through each other's filters
+  FilterBank genFilters;  // Generators with their own filter params, one lane each
+  juce::dsp::StateVariableTPTFilter<float> noteFilter;  // Shared by the generators using the note's filter params
+  // Output of the last rendered sub-block, sized in VoicePool::prepare()
+  juce::AudioBuffer<float> mixBuffer;
+  juce::AudioBuffer<float> globalBuffer;                 // Generators that still need to go through the global filter
+  const ParamGenResolved* globalFilterParams = nullptr;  // nullptr if nothing was added to globalBuffer
+
+  // Resets the voice for a new note
+  void start(int midiNote_, Utils::PitchClass pitchClass_, float velocity_, long ts) {
+    midiNote = midiNote_;
+    pitchClass = pitchClass_;
+    velocity = velocity_;
+    startTs = ts;
+    removeTs = -1;
+    stealTs = -1;
+    for (size_t i = 0; i < NUM_GENERATORS; ++i) {
+      genGrains[i].size = 0;
+      genAmpEnvs[i].noteOn(ts);  // Set note on for each position as well
+    }
+    genFilters.reset();
+    noteFilter.reset();
+  }
+};
+
+/**
+ * Every GrainNote the synth can play at once, allocated up front. Unused voices sit on a lock-free stack, so starting a note never
+ * allocates or locks. Voices can be acquired from any thread, but only the audio thread releases them.
+ */
+class VoicePool {
+ public:
+  // Room for ParamEngine::MAX_VOICES playing plus the voices that were stolen and are still fading out. Everything sized per voice
+  // (grain pool, scheduler, render jobs) uses this, the voice limit itself comes from ParamEngine.
+  static constexpr int NUM_FADING_VOICES = 8;
+  static constexpr int MAX_VOICES = ParamEngine::MAX_VOICES + NUM_FADING_VOICES;
+
+  VoicePool();
+
+  // Sets up the filters and output buffers of every voice, not real-time safe
+  void prepare(const juce::dsp::ProcessSpec& spec);
+  // Puts every voice back on the free list, only to be called when no other thread can start a note
+  void reset();
+
+  // Takes a voice from the free list, nullptr if all voices are playing
+  GrainNote* acquire();
+  // Makes an acquired voice visible to getActive() once it is fully set up
+  void activate(GrainNote* voice);
+  // Stops an active voice and puts it back on the free list
+  void release(GrainNote* voice);
+
+  // Returns the voice at index if it is playing, otherwise nullptr
+  GrainNote* getActive(int index) {
+    return mActive[static_cast<size_t>(index)].load(std::memory_order_acquire) ? &mVoices[static_cast<size_t>(index)] : nullptr;
+  }
+  int getNumActive() const { return mNumActive.load(std::memory_order_relaxed); }
+  int getIndex(const GrainNote* voice) const { return static_cast<int>(voice - mVoices.data()); }
+
+ private:
+  static constexpr juce::uint32 EMPTY = 0xFFFFFFFF;
+
+  void push(juce::uint32 index);
+
+  std::array<GrainNote, MAX_VOICES> mVoices;
+  std::array<std::atomic<bool>, MAX_VOICES> mActive;
+  std::atomic<int> mNumActive{0};
+
+  // Free list head packed as (tag << 32 | index). The tag changes on every update so a pop can't succeed against a head that was
+  // popped and pushed back in between (ABA).
+  std::atomic<juce::uint64> mFreeHead{EMPTY};
+  std::array<std::atomic<juce::uint32>, MAX_VOICES> mNextFree;
+  static_assert(std::atomic<juce::uint64>::is_always_lock_free, "Voice free list needs a lock-free 64-bit atomic");
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VoicePool)
+};
+
@@ -24,14 +24,11 @@ void ParamGlobal::addParams(juce::AudioProcessor& p) {
   p.addParameter(common[FILT_CUTOFF] =
                      new juce::AudioParameterFloat({ParamIDs::globalFilterCutoff, 1}, "Master Filter Cutoff", ParamRanges::CUTOFF,
                                                    ParamDefaults::FILTER_LP_CUTOFF_DEFAULT_HZ));
-  common[FILT_CUTOFF]->addListener(this);
   p.addParameter(common[FILT_RESONANCE] =
                      new juce::AudioParameterFloat({ParamIDs::globalFilterResonance, 1}, "Master Filter Resonance",
                                                    ParamRanges::RESONANCE, ParamDefaults::FILTER_RESONANCE_DEFAULT));
-  common[FILT_RESONANCE]->addListener(this);
   p.addParameter(common[FILT_TYPE] =
                      new juce::AudioParameterChoice({ParamIDs::globalFilterType, 1}, "Master Filter Type", FILTER_TYPE_NAMES, 0));
-  common[FILT_TYPE]->addListener(this);
 
   p.addParameter(common[GRAIN_SHAPE] = new juce::AudioParameterFloat({ParamIDs::globalGrainShape, 1}, "Master Grain Shape",
                                                                      ParamRanges::GRAIN_SHAPE, ParamDefaults::GRAIN_SHAPE_DEFAULT));
@@ -83,18 +80,14 @@ void ParamGenerator::addParams(juce::AudioProcessor& p) {
   juce::String releaseId = PITCH_CLASS_NAMES[noteIdx] + ParamIDs::genRelease + juce::String(genIdx);
   p.addParameter(common[RELEASE] =
                      new juce::AudioParameterFloat({releaseId, 1}, releaseId, ParamRanges::RELEASE, ParamDefaults::RELEASE_DEFAULT_SEC));
-  // Filter params have listeners to set juce::dsp::StateVariableFilter parameters when changed
   juce::String cutoffId = PITCH_CLASS_NAMES[noteIdx] + ParamIDs::genFilterCutoff + juce::String(genIdx);
   p.addParameter(common[FILT_CUTOFF] = new juce::AudioParameterFloat({cutoffId, 1}, cutoffId, ParamRanges::CUTOFF,
                                                                      ParamDefaults::FILTER_LP_CUTOFF_DEFAULT_HZ));
-  common[FILT_CUTOFF]->addListener(this);
   juce::String resonanceId = PITCH_CLASS_NAMES[noteIdx] + ParamIDs::genFilterResonance + juce::String(genIdx);
   p.addParameter(common[FILT_RESONANCE] = new juce::AudioParameterFloat({resonanceId, 1}, resonanceId, ParamRanges::RESONANCE,
                                                                         ParamDefaults::FILTER_RESONANCE_DEFAULT));
-  common[FILT_RESONANCE]->addListener(this);
   juce::String filterTypeId = PITCH_CLASS_NAMES[noteIdx] + ParamIDs::genFilterType + juce::String(genIdx);
   p.addParameter(common[FILT_TYPE] = new juce::AudioParameterChoice({filterTypeId, 1}, filterTypeId, FILTER_TYPE_NAMES, 0));
-  common[FILT_TYPE]->addListener(this);
   juce::String pitchAdjustId = PITCH_CLASS_NAMES[noteIdx] + ParamIDs::genPitchAdjust + juce::String(genIdx);
   p.addParameter(common[PITCH_ADJUST] = new juce::AudioParameterFloat({pitchAdjustId, 1}, pitchAdjustId, ParamRanges::PITCH_ADJUST,
                                                                       ParamDefaults::PITCH_ADJUST_DEFAULT));
@@ -151,14 +144,11 @@ void ParamNote::addParams(juce::AudioProcessor& p) {
   p.addParameter(common[FILT_CUTOFF] =
                      new juce::AudioParameterFloat({notePrefix + ParamIDs::noteFilterCutoff, 1}, notePrefix + ParamIDs::noteFilterCutoff,
                                                    ParamRanges::CUTOFF, ParamDefaults::FILTER_LP_CUTOFF_DEFAULT_HZ));
-  common[FILT_CUTOFF]->addListener(this);
   p.addParameter(common[FILT_RESONANCE] = new juce::AudioParameterFloat({
                      notePrefix + ParamIDs::noteFilterResonance, 1}, notePrefix + ParamIDs::noteFilterResonance, ParamRanges::RESONANCE,
                      ParamDefaults::FILTER_RESONANCE_DEFAULT));
-  common[FILT_RESONANCE]->addListener(this);
   p.addParameter(common[FILT_TYPE] = new juce::AudioParameterChoice({notePrefix + ParamIDs::noteFilterType, 1},
                                                                     notePrefix + ParamIDs::noteFilterType, FILTER_TYPE_NAMES, 0));
-  common[FILT_TYPE]->addListener(this);
 
   p.addParameter(common[GRAIN_SHAPE] = new juce::AudioParameterFloat({notePrefix + ParamIDs::noteGrainShape, 1}, notePrefix + ParamIDs::noteGrainShape,
                                                    ParamRanges::GRAIN_SHAPE, ParamDefaults::GRAIN_SHAPE_DEFAULT));
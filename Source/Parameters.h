@@ -162,17 +162,10 @@ namespace ParamHelper {
 }
 
 // Common parameters types used by each generator, note and globally
-class ParamCommon : public juce::AudioProcessorParameter::Listener {
+class ParamCommon {
  public:
-  ParamCommon(ParamType _type) : type(_type) {
-    filter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
-    filter.setCutoffFrequency(ParamDefaults::FILTER_LP_CUTOFF_DEFAULT_HZ);
-  }
-  ~ParamCommon() override {
-    common[FILT_TYPE]->removeListener(this);
-    common[FILT_CUTOFF]->removeListener(this);
-    common[FILT_RESONANCE]->removeListener(this);
-  }
+  ParamCommon(ParamType _type) : type(_type) {}
+  virtual ~ParamCommon() = default;
 
   enum Type {
     GAIN = 0,
@@ -241,6 +234,8 @@ class ParamCommon : public juce::AudioProcessorParameter::Listener {
   }
 
   void resetParams() {
+    // Clear the flags first so anything listening for the value changes sees the final state
+    for (int i = 0; i < Type::NUM_COMMON; ++i) { setUsed(static_cast<Type>(i), false); }
     ParamHelper::setParam(P_FLOAT(common[GAIN]), ParamDefaults::GAIN_DEFAULT);
     ParamHelper::setParam(P_FLOAT(common[ATTACK]), ParamDefaults::ATTACK_DEFAULT_SEC);
     ParamHelper::setParam(P_FLOAT(common[DECAY]), ParamDefaults::DECAY_DEFAULT_SEC);
@@ -260,43 +255,21 @@ class ParamCommon : public juce::AudioProcessorParameter::Listener {
     ParamHelper::setParam(P_FLOAT(common[GRAIN_RATE]), ParamDefaults::GRAIN_RATE_DEFAULT);
     ParamHelper::setParam(P_FLOAT(common[GRAIN_DURATION]), ParamDefaults::GRAIN_DURATION_DEFAULT);
     ParamHelper::setParam(P_BOOL(common[GRAIN_SYNC]), ParamDefaults::GRAIN_SYNC_DEFAULT);
-    for (auto& used : isUsed) { used = false; }
   }
 
-  void parameterValueChanged(int paramIdx, float) override {
-    if (paramIdx == common[FILT_TYPE]->getParameterIndex()) {
-      switch (P_CHOICE(common[FILT_TYPE])->getIndex()) {
-        case Utils::FilterType::LOWPASS: {
-          filter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
-          break;
-        }
-        case Utils::FilterType::HIGHPASS: {
-          filter.setType(juce::dsp::StateVariableTPTFilterType::highpass);
-          break;
-        }
-        case Utils::FilterType::BANDPASS: {
-          filter.setType(juce::dsp::StateVariableTPTFilterType::bandpass);
-          break;
-        }
-        default:
-          break;
-      }
-    } else if (paramIdx == common[FILT_CUTOFF]->getParameterIndex()) {
-      filter.setCutoffFrequency(P_FLOAT(common[FILT_CUTOFF])->get());
-    } else if (paramIdx == common[FILT_RESONANCE]->getParameterIndex()) {
-      filter.setResonance(P_FLOAT(common[FILT_RESONANCE])->get());
-    }
+  // Setting a parameter to the value it already has doesn't notify its listeners, so a flag changing raises usedChanged on its own
+  void setUsed(Type paramType, bool used) {
+    if (isUsed[paramType] == used) return;
+    isUsed[paramType] = used;
+    if (usedChanged != nullptr) usedChanged->store(true);
   }
-  void parameterGestureChanged(int, bool) override {}
 
   juce::RangedAudioParameter* common[Type::NUM_COMMON];
-  bool isUsed[Type::NUM_COMMON]; // Flag for each parameter set to true when changed from its default
+  bool isUsed[Type::NUM_COMMON] = {}; // Flag for each parameter set to true when changed from its default
+  std::atomic<bool>* usedChanged = nullptr;  // Raised whenever an isUsed flag changes
 
   // Type of derived class
   ParamType type;
-  // State variable filter for generator
-  juce::dsp::StateVariableTPTFilter<float> filter;
-  double sampleRate = 48000;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParamCommon)
 };
@@ -324,16 +297,19 @@ static float COMMON_DEFAULTS[ParamCommon::Type::NUM_COMMON] = {ParamDefaults::GA
 
 namespace ParamHelper {
 [[maybe_unused]] static void setCommonParam(ParamCommon* common, ParamCommon::Type type, float newValue) {
+  // Flag before setting so listeners that resolve the hierarchy see the new value as used
+  common->setUsed(type, true);
   ParamHelper::setParam(P_FLOAT(common->common[type]), newValue);
-  common->isUsed[type] = true;
 }
 [[maybe_unused]] static void setCommonParam(ParamCommon* common, ParamCommon::Type type, int newValue) {
+  // Flag before setting so listeners that resolve the hierarchy see the new value as used
+  common->setUsed(type, true);
   ParamHelper::setParam(P_CHOICE(common->common[type]), newValue);
-  common->isUsed[type] = true;
 }
 [[maybe_unused]] static void setCommonParam(ParamCommon* common, ParamCommon::Type type, bool newValue) {
+  // Flag before setting so listeners that resolve the hierarchy see the new value as used
+  common->setUsed(type, true);
   ParamHelper::setParam(P_BOOL(common->common[type]), newValue);
-  common->isUsed[type] = true;
 }
 }
 
@@ -639,11 +615,130 @@ struct ParamUI {
   bool referenceToneActive = false;
 };
 
-struct Parameters {
+// Settings for how the synth engine runs rather than how it sounds, saved with the plugin state but not automatable
+struct ParamEngine {
+  static constexpr int MIN_VOICES = 1;
+  static constexpr int MAX_VOICES = 24;  // The voice pool keeps spare voices on top of this for stolen voices fading out
+  static constexpr int DEFAULT_VOICES = 16;
+  static constexpr float DEFAULT_LOAD_THRESHOLD = 0.8f;
+  static constexpr float DEFAULT_MISS_THRESHOLD = 0.9f;
+
+  // Settings missing from xml, saved by an older version, keep their current value
+  void setXml(juce::XmlElement* xml) {
+    if (xml != nullptr) {
+      maxVoices.store(juce::jlimit(MIN_VOICES, MAX_VOICES, xml->getIntAttribute("maxVoices", maxVoices.load())));
+      loadGovernor.store(xml->getBoolAttribute("loadGovernor", loadGovernor.load()));
+      loadThreshold.store(static_cast<float>(xml->getDoubleAttribute("loadThreshold", loadThreshold.load())));
+      missThreshold.store(static_cast<float>(xml->getDoubleAttribute("missThreshold", missThreshold.load())));
+      interpolation.store(xml->getIntAttribute("interpolation", interpolation.load()));
+      seed.store(xml->getStringAttribute("seed", juce::String(seed.load())).getLargeIntValue());
+      deterministic.store(xml->getBoolAttribute("deterministic", deterministic.load()));
+      offlineQuality.store(xml->getBoolAttribute("offlineQuality", offlineQuality.load()));
+      offlineOversampling.store(xml->getIntAttribute("offlineOversampling", offlineOversampling.load()));
+    }
+  }
+
+  juce::XmlElement* getXml() {
+    juce::XmlElement* xml = new juce::XmlElement("ParamEngine");
+    xml->setAttribute("maxVoices", maxVoices.load());
+    xml->setAttribute("loadGovernor", loadGovernor.load());
+    xml->setAttribute("loadThreshold", loadThreshold.load());
+    xml->setAttribute("missThreshold", missThreshold.load());
+    xml->setAttribute("interpolation", interpolation.load());
+    xml->setAttribute("seed", juce::String(seed.load()));
+    xml->setAttribute("deterministic", deterministic.load());
+    xml->setAttribute("offlineQuality", offlineQuality.load());
+    xml->setAttribute("offlineOversampling", offlineOversampling.load());
+    return xml;
+  }
+
+  // Most notes that can sound at once before the quietest/cheapest one is stolen
+  std::atomic<int> maxVoices{DEFAULT_VOICES};
+  // Thins out the grain cloud when processBlock gets close to using up its time
+  std::atomic<bool> loadGovernor{true};
+  std::atomic<float> loadThreshold{DEFAULT_LOAD_THRESHOLD};  // Proportion of the block deadline
+  // Blocks taking longer than this proportion of their deadline are written to the deadline miss log, 0 turns it off
+  std::atomic<float> missThreshold{DEFAULT_MISS_THRESHOLD};
+  std::atomic<int> interpolation{0};  // Interpolation::Quality grains are read from the source with
+  // Project seed the grain spray of every voice is drawn from, mixed with the voice's note and start time
+  std::atomic<juce::int64> seed{0};
+  // Turns off everything that depends on timing instead of the input (load governor, partly built source levels) so the same midi
+  // and parameters always render the same samples
+  std::atomic<bool> deterministic{false};
+  // When the host bounces offline: sinc interpolation, no load governor and every core, as there is no deadline to keep
+  std::atomic<bool> offlineQuality{true};
+  std::atomic<int> offlineOversampling{1};  // 1, 2 or 4 times, only used with offlineQuality and taking effect on the next prepare
+};
+
+/**
+ * The effective value of every common parameter of a single generator after walking the generator -> note -> global hierarchy.
+ * Plain data so the audio thread can read it without any casting or virtual calls.
+ */
+struct ParamGenResolved {
+  float gain;
+  float attack;  // attack, decay and release in seconds
+  float decay;
+  float sustain;
+  float release;
+  // Filter settings come from the lowest level that changed any filter param, that level also decides which filter instance the
+  // generator runs through: its own per voice filter, the voice's shared note filter or the single global filter on the mix
+  ParamType filtScope;
+  float filtCutoff;
+  float filtResonance;
+  int filtType;
+  float grainShape;
+  float grainTilt;
+  float grainRate;
+  float grainDuration;
+  bool grainSync;
+  // Bar divisions the grain duration and the time between grains are synced to, powers of 2
+  int syncDurationDiv;
+  int syncRateDiv;
+  float pitchAdjust;
+  float pitchSpray;
+  float posAdjust;
+  float posSpray;
+  float panAdjust;
+  float panSpray;
+  bool shouldPlay;  // enabled and not muted by a solo
+};
+
+struct Parameters : juce::AudioProcessorParameter::Listener {
   // The 3 types of parameter sets
   ParamUI ui;
   ParamGlobal global;
   ParamsNote note;
+  ParamEngine engine;
+
+  // Resolved parameters for each note's generators, only valid after resolveGenerators() was called
+  std::array<std::array<ParamGenResolved, NUM_GENERATORS>, Utils::PitchClass::COUNT> resolved;
+  // Set by any audio parameter changing, the synth needs to be added as a listener to each parameter
+  std::atomic<bool> resolvedStale{true};
+
+  Parameters() {
+    // Which level a generator's parameter comes from can change without any parameter's value changing
+    global.usedChanged = &resolvedStale;
+    for (auto&& paramNote : note.notes) {
+      paramNote->usedChanged = &resolvedStale;
+      for (auto&& paramGen : paramNote->generators) {
+        paramGen->usedChanged = &resolvedStale;
+      }
+    }
+  }
+
+  void parameterValueChanged(int, float) override { resolvedStale.store(true); }
+  void parameterGestureChanged(int, bool) override {}
+
+  // Rebuilds the resolved parameters if anything changed since the last call.
+  // Expected to be called once at the start of each audio block.
+  void resolveGenerators() {
+    if (!resolvedStale.exchange(false)) return;
+    for (auto&& paramNote : note.notes) {
+      for (auto&& paramGen : paramNote->generators) {
+        resolveGenerator(paramGen.get(), resolved[paramNote->noteIdx][paramGen->genIdx]);
+      }
+    }
+  }
 
   // Called when current selected note or generator changes
   // Should be used only by PluginEditor and passed on to subcomponents
@@ -742,29 +837,42 @@ struct Parameters {
     // Just use the global value
     return P_BOOL(global.common[type])->get();
   }
-  std::vector<float> getGrainEnv(ParamCommon* common) {
-    const float shape = getFloatParam(common, ParamCommon::Type::GRAIN_SHAPE);
-    const float tilt = getFloatParam(common, ParamCommon::Type::GRAIN_TILT);
-    return Utils::getGrainEnvelopeLUT(shape, tilt);
-  }
-  float getFilterOutput(ParamCommon* common, int ch, float sample) {
-    ParamGenerator* pGen = dynamic_cast<ParamGenerator*>(common);
-    ParamNote* pNote = dynamic_cast<ParamNote*>(common);
-    if (pGen != nullptr) {
-      // If gen values are used, return it
-      if (pGen->isUsed[ParamCommon::Type::FILT_TYPE] || pGen->isUsed[ParamCommon::Type::FILT_CUTOFF] || pGen->isUsed[ParamCommon::Type::FILT_RESONANCE]) {
-        return pGen->filter.processSample(ch, sample);
-      }
-      pNote = note.notes[pGen->noteIdx].get();
-    }
-    if (pNote != nullptr) {
-      // Otherwise if note value is different from global, return it
-      if (pNote->isUsed[ParamCommon::Type::FILT_TYPE] || pNote->isUsed[ParamCommon::Type::FILT_CUTOFF] || pNote->isUsed[ParamCommon::Type::FILT_RESONANCE]) {
-        return pNote->filter.processSample(ch, sample);
-      }
-    }
-
-    // Just use the global value
-    return global.filter.processSample(ch, sample);
+  void resolveGenerator(ParamGenerator* gen, ParamGenResolved& out) {
+    out.gain = getFloatParam(gen, ParamCommon::Type::GAIN);
+    out.attack = getFloatParam(gen, ParamCommon::Type::ATTACK);
+    out.decay = getFloatParam(gen, ParamCommon::Type::DECAY);
+    out.sustain = getFloatParam(gen, ParamCommon::Type::SUSTAIN);
+    out.release = getFloatParam(gen, ParamCommon::Type::RELEASE);
+    ParamCommon* filterParams = getFilterParams(gen);
+    out.filtScope = filterParams->type;
+    out.filtCutoff = P_FLOAT(filterParams->common[ParamCommon::Type::FILT_CUTOFF])->get();
+    out.filtResonance = P_FLOAT(filterParams->common[ParamCommon::Type::FILT_RESONANCE])->get();
+    out.filtType = P_CHOICE(filterParams->common[ParamCommon::Type::FILT_TYPE])->getIndex();
+    out.grainShape = getFloatParam(gen, ParamCommon::Type::GRAIN_SHAPE);
+    out.grainTilt = getFloatParam(gen, ParamCommon::Type::GRAIN_TILT);
+    out.grainRate = getFloatParam(gen, ParamCommon::Type::GRAIN_RATE);
+    out.grainDuration = getFloatParam(gen, ParamCommon::Type::GRAIN_DURATION);
+    out.grainSync = getBoolParam(gen, ParamCommon::Type::GRAIN_SYNC);
+    out.syncDurationDiv =
+        1 << static_cast<int>(ParamRanges::SYNC_DIV_MAX * ParamRanges::GRAIN_DURATION.convertTo0to1(out.grainDuration));
+    out.syncRateDiv = 1 << static_cast<int>(ParamRanges::SYNC_DIV_MAX * ParamRanges::GRAIN_RATE.convertTo0to1(out.grainRate));
+    out.pitchAdjust = getFloatParam(gen, ParamCommon::Type::PITCH_ADJUST);
+    out.pitchSpray = getFloatParam(gen, ParamCommon::Type::PITCH_SPRAY);
+    out.posAdjust = getFloatParam(gen, ParamCommon::Type::POS_ADJUST);
+    out.posSpray = getFloatParam(gen, ParamCommon::Type::POS_SPRAY);
+    out.panAdjust = getFloatParam(gen, ParamCommon::Type::PAN_ADJUST);
+    out.panSpray = getFloatParam(gen, ParamCommon::Type::PAN_SPRAY);
+    out.shouldPlay = note.notes[gen->noteIdx]->shouldPlayGenerator(gen->genIdx);
+  }
+  // Returns the lowest level that changed any of the filter params
+  ParamCommon* getFilterParams(ParamGenerator* gen) {
+    auto filterUsed = [](ParamCommon* common) {
+      return common->isUsed[ParamCommon::Type::FILT_TYPE] || common->isUsed[ParamCommon::Type::FILT_CUTOFF] ||
+             common->isUsed[ParamCommon::Type::FILT_RESONANCE];
+    };
+    if (filterUsed(gen)) return gen;
+    ParamNote* pNote = note.notes[gen->noteIdx].get();
+    if (filterUsed(pNote)) return pNote;
+    return &global;
   }
 };
@@ -14,16 +14,6 @@
 #include "Utils/Colour.h"
 #include "Utils/MidiNote.h"
 
-// Used for getting memory usage
-#ifdef __linux__
-#include <sys/sysinfo.h>
-#include <unistd.h>
-#endif
-#ifdef _WINDOWS
-#include <windows.h>
-#include <Psapi.h>
-#endif
-
 GRainbowLogo::GRainbowLogo() { mLogoImage = juce::PNGImageFormat::loadFrom(BinaryData::logo_png, BinaryData::logo_pngSize); }
 
 void GRainbowLogo::paint(juce::Graphics& g) {
@@ -40,7 +30,7 @@ GRainbowAudioProcessorEditor::GRainbowAudioProcessorEditor(GranularSynth& synth)
       mArcSpec(synth.getParams()),
       mTrimSelection(synth.getFormatManager(), synth.getParamUI()),
       mProgressBar(mParameters.ui.loadingProgress),
-      mKeyboard(synth.getKeyboardState(), synth.getParams()),
+      mKeyboard(synth.getUiNoteEvents(), synth.getParams()),
       mEnvAdsr(synth.getParams()),
       mEnvGrain(synth.getParams()),
       mGrainControl(synth.getParams(), synth.getMeterSource()),
@@ -147,7 +137,7 @@ GRainbowAudioProcessorEditor::GRainbowAudioProcessorEditor(GranularSynth& synth)
     } else {
       mParameters.ui.trimPlaybackOn = false;
       mSynth.resetParameters();
-      mSynth.trimAudioBuffer(mSynth.getInputBuffer(), mSynth.getAudioBuffer(), juce::Range<juce::int64>(start, end));
+      mSynth.trimSource(juce::Range<juce::int64>(start, end));
       mSynth.extractSpectrograms();
       mSynth.extractPitches();
       mSynth.getInputBuffer();
@@ -187,6 +177,7 @@ GRainbowAudioProcessorEditor::GRainbowAudioProcessorEditor(GranularSynth& synth)
     mSynth.stopReferenceTone();
   };
   addAndMakeVisible(mGrainControl);
+  addChildComponent(mPerfHud);
 
   mCloudLeftImage = juce::PNGImageFormat::loadFrom(BinaryData::cloudLeft_png, BinaryData::cloudLeft_pngSize);
   mCloudRightImage = juce::PNGImageFormat::loadFrom(BinaryData::cloudRight_png, BinaryData::cloudRight_pngSize);
@@ -258,47 +249,31 @@ void GRainbowAudioProcessorEditor::timerCallback() {
   }
 
   // Get notes being played, send off to each children and then redraw.
-  // Grab the notes from the Synth instead of MidiKeyboardState::Listener to not block the thread to draw.
+  // Grab the snapshot of held notes the audio thread publishes so drawing never blocks or races the audio thread.
   // There is a chance notes are pressed and released inbetween timer callback if they are super short, but can always increase the
   // callback timer
-  const juce::Array<Utils::MidiNote>& midiNotes = mSynth.getMidiNotes();
+  const juce::Array<Utils::MidiNote> midiNotes = mSynth.getMidiNotes();
   // Each component has has a different use for the midi notes, so just give them the notes and have them do what logic they want
   // with it
   mKeyboard.setMidiNotes(midiNotes);
   mArcSpec.setMidiNotes(midiNotes);
 
-  /* if (PowerUserSettings::get().getResourceUsage()) {
-    const double cpuPerc = mAudioDeviceManager.getCpuUsage() * 100;
-    size_t virtual_memory = 0;
-    size_t resident_memory = 0;
-#if defined(__linux__)
-    FILE* file = fopen("/proc/self/statm", "r");
-    if (file) {
-      unsigned long VmSize = 0;
-      unsigned long VmRSS = 0;
-      fscanf(file, "%lu %lu", &VmSize, &VmRSS);
-      fclose(file);
-      virtual_memory = static_cast<size_t>(VmSize) * getpagesize();
-      resident_memory = static_cast<size_t>(VmRSS) * getpagesize();
-    }
-#elif defined(_WINDOWS)
-    // According to MSDN
-    PROCESS_MEMORY_COUNTERS counters;
-    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
-      virtual_memory = counters.PagefileUsage;
-      resident_memory = counters.WorkingSetSize;
-    }
-#endif
-
-    mResourceUsage.setText(juce::String(cpuPerc, 1) + "% CPU | Virtual " + juce::String(virtual_memory >> 20) + " MB" +
-                               " | Resident " +
-                               juce::String(resident_memory >> 20) + " MB",
-                           juce::dontSendNotification);
-  }*/
+  // Resource usage overlay, also toggled with ctrl/cmd + shift + P so it can be turned on without the settings panel
+  const bool showPerf = PowerUserSettings::get().getResourceUsage();
+  mPerfHud.setVisible(showPerf);
+  if (showPerf) mPerfHud.update(mSynth.getPerfSnapshot());
 
   repaint();
 }
 
+bool GRainbowAudioProcessorEditor::keyPressed(const juce::KeyPress& key) {
+  if (key == juce::KeyPress('p', juce::ModifierKeys::commandModifier | juce::ModifierKeys::shiftModifier, 0)) {
+    PowerUserSettings::get().setResourceUsage(!PowerUserSettings::get().getResourceUsage());
+    return true;
+  }
+  return false;
+}
+
 //==============================================================================
 void GRainbowAudioProcessorEditor::paint(juce::Graphics& g) {
   // Set gradient
@@ -329,7 +304,7 @@ void GRainbowAudioProcessorEditor::paintOverChildren(juce::Graphics& g) {
   // Right now just give last note played, not truely polyphony yet
   // TODO: new note displaying
   /*
-  const juce::Array<Utils::MidiNote>& midiNotes = mSynth.getMidiNotes();
+  const juce::Array<Utils::MidiNote> midiNotes = mSynth.getMidiNotes();
   if (!midiNotes.isEmpty()) {
     // If there are not candidates, will just not draw any arrows/lines
     std::vector<ParamCandidate*> candidates = mSynth.getActiveCandidates();
@@ -452,6 +427,7 @@ void GRainbowAudioProcessorEditor::resized() {
   mArcSpec.setBounds(centerRect);
   mTrimSelection.setBounds(centerRect);
   mProgressBar.setBounds(centerRect.withSizeKeepingCentre(PROGRESS_SIZE, PROGRESS_SIZE));
+  mPerfHud.setTopLeftPosition(centerRect.getTopLeft().translated(Utils::PADDING, Utils::PADDING));
 
   // Border path around children
   const float halfRound = Utils::ROUNDED_AMOUNT / 2.0f;
@@ -692,7 +668,10 @@ void GRainbowAudioProcessorEditor::savePreset() {
 
       // Write data out section by section
       outputStream.write(&header, sizeof(header));
-      outputStream.write(reinterpret_cast<const void*>(audioBuffer.getReadPointer(0)), header.audioBufferSize);
+      for (int c = 0; c < audioBuffer.getNumChannels(); c++) {
+        outputStream.write(reinterpret_cast<const void*>(audioBuffer.getReadPointer(c)),
+                           header.audioBufferNumberOfSamples * sizeof(float));
+      }
       outputStream.write(spectrogramStaging.getData(), header.specImageSpectrogramSize);
       outputStream.write(hpcpStaging.getData(), header.specImageHpcpSize);
       outputStream.write(detectedStaging.getData(), header.specImageDetectedSize);
@@ -20,6 +20,7 @@
 #include "Components/FilterControl.h"
 #include "Components/TrimSelection.h"
 #include "Components/Settings.h"
+#include "Components/PerfHud.h"
 #include "Components/RainbowLookAndFeel.h"
 #include "DSP/AudioRecorder.h"
 #include "DSP/Fft.h"
@@ -62,6 +63,7 @@ class GRainbowAudioProcessorEditor : public juce::AudioProcessorEditor,
   void filesDropped(const juce::StringArray& files, int x, int y) override;
 
   void timerCallback() override;
+  bool keyPressed(const juce::KeyPress& key) override;
 
   void fastDebugMode();
 
@@ -100,6 +102,7 @@ class GRainbowAudioProcessorEditor : public juce::AudioProcessorEditor,
   juce::Rectangle<float> mNoteDisplayRect;
   juce::SharedResourcePointer<juce::TooltipWindow> mTooltipWindow;
   SettingsComponent mSettings;
+  PerfHud mPerfHud;
 
   // Bookkeeping
   juce::File mRecordedFile;
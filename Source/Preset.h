@@ -52,7 +52,7 @@ struct Header {
 // Version 0.0 layout
 // ------------------
 // - Header
-// - Encoded audio buffer blob
+// - Encoded audio buffer blob, planar (every sample of a channel before the next channel)
 // - List of UI spec images as png blob
 // - XML of user param (binary form)
 
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <type_traits>
+
+namespace Utils {
+
+/**
+ * Lets one thread publish a value that another thread can copy out without either of them locking. The writer always fills the
+ * buffer the reader was not told about and then bumps a sequence number. A reader that sees the sequence number move while it was
+ * copying just tries again, which only happens if the writer published twice in that time.
+ */
+template <typename T>
+class DoubleBuffer {
+  static_assert(std::is_trivially_copyable_v<T>, "DoubleBuffer copies values without locking");
+
+ public:
+  // Only to be called from a single writer thread
+  void write(const T& value) {
+    const unsigned int seq = mSequence.load(std::memory_order_relaxed);
+    // Keeps the copy below from being seen before the previous publish
+    std::atomic_thread_fence(std::memory_order_release);
+    mBuffers[(seq + 1) & 1] = value;
+    mSequence.store(seq + 1, std::memory_order_release);
+  }
+
+  // Returns false if the writer got in the way, in which case out is not valid
+  bool tryRead(T& out) const {
+    const unsigned int seq = mSequence.load(std::memory_order_acquire);
+    out = mBuffers[seq & 1];
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return mSequence.load(std::memory_order_relaxed) == seq;
+  }
+
+  T read() const {
+    T out;
+    while (!tryRead(out)) {
+    }
+    return out;
+  }
+
+ private:
+  T mBuffers[2] = {};
+  std::atomic<unsigned int> mSequence{0};
+};
+
+}  // namespace Utils
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Utils {
+
+/**
+ * xorshift64* generator, a handful of integer ops per number and 8 bytes of state, so every voice can own one and draw grain spray
+ * values without touching a shared or clock seeded generator. The same seed always gives the same sequence on every platform.
+ */
+class FastRandom {
+ public:
+  FastRandom() { setSeed(0); }
+  explicit FastRandom(uint64_t seed) { setSeed(seed); }
+
+  // Any seed is fine, it is scrambled first so nearby seeds (note numbers, timestamps) still give unrelated sequences
+  void setSeed(uint64_t seed) {
+    mState = mix(seed);
+    // xorshift gets stuck on a zero state
+    if (mState == 0) mState = 0x9e3779b97f4a7c15ull;
+  }
+
+  uint64_t next() {
+    mState ^= mState >> 12;
+    mState ^= mState << 25;
+    mState ^= mState >> 27;
+    return mState * 0x2545f4914f6cdd1dull;
+  }
+
+  // Uniform in [0, 1), uses the top 24 bits so every value is exactly representable
+  float nextFloat() { return static_cast<float>(next() >> 40) * (1.0f / 16777216.0f); }
+  bool nextBool() { return (next() >> 63) != 0; }
+
+  // splitmix64 finalizer, also handy for combining several values into one seed
+  static uint64_t mix(uint64_t value) {
+    value += 0x9e3779b97f4a7c15ull;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+  }
+
+ private:
+  uint64_t mState;
+};
+
+}  // namespace Utils
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+
+namespace Utils {
+
+// A note pressed or released from somewhere other than the host's midi input (currently just the on-screen keyboard)
+struct NoteEvent {
+  int midiNote = 0;
+  float velocity = 0.0f;
+  bool isNoteOn = false;
+};
+
+/**
+ * Single producer/single consumer lock-free queue of note events. The message thread pushes and the audio thread pops at the start
+ * of each block, so neither side ever waits on the other.
+ */
+class NoteEventFifo {
+ public:
+  static constexpr int CAPACITY = 256;
+
+  NoteEventFifo() : mFifo(CAPACITY) {}
+
+  // Returns false if the queue is full and the event was dropped
+  bool push(const NoteEvent& event) {
+    const juce::AbstractFifo::ScopedWrite write = mFifo.write(1);
+    if (write.blockSize1 + write.blockSize2 == 0) return false;
+    mEvents[static_cast<size_t>(write.blockSize1 > 0 ? write.startIndex1 : write.startIndex2)] = event;
+    return true;
+  }
+
+  // Returns false if there is nothing to pop
+  bool pop(NoteEvent& event) {
+    const juce::AbstractFifo::ScopedRead read = mFifo.read(1);
+    if (read.blockSize1 + read.blockSize2 == 0) return false;
+    event = mEvents[static_cast<size_t>(read.blockSize1 > 0 ? read.startIndex1 : read.startIndex2)];
+    return true;
+  }
+
+  void pushNoteOn(int midiNote, float velocity) { push({midiNote, velocity, true}); }
+  void pushNoteOff(int midiNote) { push({midiNote, 0.0f, false}); }
+
+ private:
+  juce::AbstractFifo mFifo;
+  std::array<NoteEvent, CAPACITY> mEvents;
+
+  JUCE_DECLARE_NON_COPYABLE(NoteEventFifo)
+};
+
+}  // namespace Utils
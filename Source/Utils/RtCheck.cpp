@@ -0,0 +1,169 @@
+/*
+  ==============================================================================
+
+    RtCheck.cpp
+    Created: 19 Oct 2026 5:03:41am
+
+  ==============================================================================
+*/
+
+#include "RtCheck.h"
+
+#if GRAINBOW_RT_CHECK_ACTIVE
+
+#include <dlfcn.h>
+#include <pthread.h>
+
+#include <atomic>
+#include <cerrno>
+#include <mutex>
+
+// glibc's own allocator entry points, which the replacements below forward to
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+}
+
+namespace {
+
+// initial-exec so reading them from inside malloc never has to allocate the thread's storage first
+__attribute__((tls_model("initial-exec"))) thread_local int tAudioDepth = 0;
+// Set while a violation is being recorded, which allocates and locks itself
+__attribute__((tls_model("initial-exec"))) thread_local bool tRecording = false;
+
+std::atomic<int> sNumViolations{0};
+
+struct Store {
+  std::mutex mutex;
+  juce::Array<Utils::RtCheck::Violation> violations;
+};
+
+Store& getStore() {
+  static Store store;
+  return store;
+}
+
+void recordViolation(const char* function) {
+  if (tAudioDepth == 0 || tRecording) return;
+  tRecording = true;
+  sNumViolations.fetch_add(1, std::memory_order_relaxed);
+  const juce::String stackTrace = juce::SystemStats::getStackBacktrace();
+  Store& store = getStore();
+  {
+    std::lock_guard<std::mutex> lock(store.mutex);
+    bool found = false;
+    for (Utils::RtCheck::Violation& violation : store.violations) {
+      if (violation.stackTrace == stackTrace && violation.function == function) {
+        ++violation.count;
+        found = true;
+        break;
+      }
+    }
+    if (!found && store.violations.size() < Utils::RtCheck::MAX_REPORTS) {
+      store.violations.add({function, stackTrace, 1});
+    }
+  }
+  tRecording = false;
+}
+
+using MutexLockFunction = int (*)(pthread_mutex_t*);
+std::atomic<MutexLockFunction> sRealMutexLock{nullptr};
+
+}  // namespace
+
+// Replacements picked over glibc's at link time. operator new, juce::HeapBlock and std::mutex all end up in one of these.
+extern "C" {
+
+__attribute__((visibility("default"))) void* malloc(size_t size) noexcept {
+  recordViolation("malloc");
+  return __libc_malloc(size);
+}
+
+__attribute__((visibility("default"))) void* calloc(size_t count, size_t size) noexcept {
+  recordViolation("calloc");
+  return __libc_calloc(count, size);
+}
+
+__attribute__((visibility("default"))) void* realloc(void* ptr, size_t size) noexcept {
+  recordViolation("realloc");
+  return __libc_realloc(ptr, size);
+}
+
+__attribute__((visibility("default"))) void* aligned_alloc(size_t alignment, size_t size) noexcept {
+  recordViolation("aligned_alloc");
+  return __libc_memalign(alignment, size);
+}
+
+__attribute__((visibility("default"))) int posix_memalign(void** ptr, size_t alignment, size_t size) noexcept {
+  if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) return EINVAL;
+  recordViolation("posix_memalign");
+  void* memory = __libc_memalign(alignment, size);
+  if (memory == nullptr) return ENOMEM;
+  *ptr = memory;
+  return 0;
+}
+
+__attribute__((visibility("default"))) void free(void* ptr) noexcept {
+  if (ptr != nullptr) recordViolation("free");
+  __libc_free(ptr);
+}
+
+__attribute__((visibility("default"))) int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept {
+  recordViolation("pthread_mutex_lock");
+  // Newer glibc doesn't export its own name for it, so the next definition in link order is looked up once
+  MutexLockFunction realMutexLock = sRealMutexLock.load(std::memory_order_acquire);
+  if (realMutexLock == nullptr) {
+    realMutexLock = reinterpret_cast<MutexLockFunction>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+    sRealMutexLock.store(realMutexLock, std::memory_order_release);
+  }
+  return realMutexLock(mutex);
+}
+
+}  // extern "C"
+
+#endif
+
+namespace Utils {
+namespace RtCheck {
+
+#if GRAINBOW_RT_CHECK_ACTIVE
+void enterAudioThread() { ++tAudioDepth; }
+void exitAudioThread() { --tAudioDepth; }
+
+int getNumViolations() { return sNumViolations.load(std::memory_order_relaxed); }
+
+juce::Array<Violation> getViolations() {
+  Store& store = getStore();
+  std::lock_guard<std::mutex> lock(store.mutex);
+  return store.violations;
+}
+
+void reset() {
+  Store& store = getStore();
+  std::lock_guard<std::mutex> lock(store.mutex);
+  store.violations.clear();
+  sNumViolations.store(0, std::memory_order_relaxed);
+}
+#else
+int getNumViolations() { return 0; }
+juce::Array<Violation> getViolations() { return {}; }
+void reset() {}
+#endif
+
+juce::String getReport() {
+  const juce::Array<Violation> violations = getViolations();
+  if (violations.isEmpty()) return {};
+  juce::String report;
+  report << getNumViolations() << " real-time safety violations on the audio thread, " << violations.size()
+         << " distinct stack traces" << (violations.size() == MAX_REPORTS ? " (more not shown)" : "") << "\n";
+  for (const Violation& violation : violations) {
+    report << "\n" << violation.function << " x" << violation.count << "\n" << violation.stackTrace;
+  }
+  return report;
+}
+
+}  // namespace RtCheck
+}  // namespace Utils
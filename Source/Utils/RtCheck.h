@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    RtCheck.h
+    Created: 19 Oct 2026 5:03:41am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+// Set by the GRAINBOW_RT_CHECK CMake option, for debug and test builds only
+#ifndef GRAINBOW_RT_CHECK
+#define GRAINBOW_RT_CHECK 0
+#endif
+
+// The checker replaces malloc and friends, which is only done against glibc
+#if GRAINBOW_RT_CHECK && defined(__GLIBC__)
+#define GRAINBOW_RT_CHECK_ACTIVE 1
+#else
+#define GRAINBOW_RT_CHECK_ACTIVE 0
+#endif
+
+namespace Utils {
+
+/**
+ * Real-time safety checker. In a GRAINBOW_RT_CHECK build, every malloc, free and mutex lock made by a thread while it is marked as
+ * doing audio work is counted as a violation and its stack trace is kept, so the benchmark and the renderer can show where it came
+ * from and fail on it. The replaced functions are only the ones the executable itself links against, so only the console tools are
+ * built with it, never the plugin or the Standalone. In any other build it all compiles down to nothing.
+ */
+namespace RtCheck {
+
+static constexpr bool IS_ACTIVE = GRAINBOW_RT_CHECK_ACTIVE;
+// Only the first distinct stack traces are kept, the same call every block would otherwise fill the report
+static constexpr int MAX_REPORTS = 32;
+
+struct Violation {
+  juce::String function;  // malloc, free, pthread_mutex_lock, ...
+  juce::String stackTrace;
+  int count;
+};
+
+#if GRAINBOW_RT_CHECK_ACTIVE
+void enterAudioThread();
+void exitAudioThread();
+#else
+inline void enterAudioThread() {}
+inline void exitAudioThread() {}
+#endif
+
+// Marks the calling thread as doing audio work while in scope, nests so the render workers can use it inside processBlock too
+class ScopedAudioThread {
+ public:
+  ScopedAudioThread() { enterAudioThread(); }
+  ~ScopedAudioThread() { exitAudioThread(); }
+
+  JUCE_DECLARE_NON_COPYABLE(ScopedAudioThread)
+};
+
+// Every violation since the last reset(), counting the ones that share a stack trace
+int getNumViolations();
+// One entry for each distinct stack trace, up to MAX_REPORTS of them
+juce::Array<Violation> getViolations();
+// Readable summary of getViolations(), empty if there were none
+juce::String getReport();
+void reset();
+
+}  // namespace RtCheck
+}  // namespace Utils
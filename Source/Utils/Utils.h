@@ -49,23 +49,34 @@ typedef struct EnvelopeADSR {
   EnvelopeState state = EnvelopeState::ATTACK;
   float amplitude = 0.0f;
   float noteOffAmplitude = 0.0f;
-  int noteOnTs = -1;
-  int noteOffTs = -1;
+  long noteOnTs = -1;
+  long noteOffTs = -1;
   EnvelopeADSR() {}
-  EnvelopeADSR(int ts) { noteOn(ts); }
-  void noteOn(int ts) {
+  EnvelopeADSR(long ts) { noteOn(ts); }
+  void noteOn(long ts) {
     noteOnTs = ts;
     noteOffTs = -1;
     state = EnvelopeState::ATTACK;
     amplitude = 0.0f;
     noteOffAmplitude = 0.0f;
   }
-  void noteOff(int ts) {
-    noteOnTs = -1;
+  // The release starts from the level the envelope has at ts, which can be later in the block than the last sample evaluated
+  void noteOff(long ts, float attack, float decay, float sustain) {
+    noteOffAmplitude = (noteOnTs < 0) ? amplitude : getHeldLevel(ts, attack, decay, sustain);
     noteOffTs = ts;
-    noteOffAmplitude = amplitude;
     state = EnvelopeState::RELEASE;
   }
+  // Level of the attack, decay and sustain at ts, as if the note was still held
+  float getHeldLevel(long ts, float attack, float decay, float sustain) const {
+    const float elapsed = static_cast<float>(ts - noteOnTs);
+    float level = sustain;
+    if (elapsed < attack) {
+      level = elapsed / attack;
+    } else if (elapsed - attack < decay) {
+      level = 1.0f - ((elapsed - attack) / decay) * (1.0f - sustain);
+    }
+    return juce::jlimit(0.0f, 1.0f, level);
+  }
   /* ADSR params (except sustain) should be in samples */
   float getAmplitude(long curTs, float attack, float decay, float sustain, float release) {
     float newAmp = 0.0f;
@@ -94,6 +105,11 @@ typedef struct EnvelopeADSR {
       }
       case Utils::EnvelopeState::RELEASE: {
         if (noteOffTs < 0) return 0.0f;
+        // The note off can land later in the block than curTs, the note is still held until then
+        if (curTs < noteOffTs) {
+          newAmp = (noteOnTs < 0) ? noteOffAmplitude : getHeldLevel(curTs, attack, decay, sustain);
+          break;
+        }
         newAmp = noteOffAmplitude - (((curTs - noteOffTs) / (float)release) * noteOffAmplitude);
         if ((curTs - noteOffTs) > release) {
           noteOffTs = -1;
@@ -124,32 +140,50 @@ class AttachedComponent {
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AttachedComponent)
 };
 
-[[maybe_unused]] static const std::vector<float> getGrainEnvelopeLUT(const float shape, const float tilt) {
-  std::vector<float> lut;
-  /* LUT divided into 3 parts
+// Fills a grain envelope table of any size without allocating so it can be used on the audio thread
+[[maybe_unused]] static void fillGrainEnvelope(float* table, const int size, const float shape, const float tilt) {
+  /* Table divided into 3 parts
 
                1.0
               -----
      rampUp  /     \  rampDown
             /       \
   */
-  float scaledShape = (shape * ENV_LUT_SIZE) / 2.0f;
-  float scaledTilt = tilt * ENV_LUT_SIZE;
-  int rampUpEndSample = juce::jmax(0.0f, scaledTilt - scaledShape);
-  int rampDownStartSample = juce::jmin((float)ENV_LUT_SIZE, scaledTilt + scaledShape);
-  for (int i = 0; i < ENV_LUT_SIZE; i++) {
-    if (i < rampUpEndSample) {
-      lut.push_back(static_cast<float>(i / rampUpEndSample));
-    } else if (i > rampDownStartSample) {
-      lut.push_back(1.0f - (float)(i - rampDownStartSample) / (ENV_LUT_SIZE - rampDownStartSample));
+  const float rampUpEnd = juce::jmax(0.0f, tilt - (shape / 2.0f));
+  const float rampDownStart = juce::jmin(1.0f, tilt + (shape / 2.0f));
+  for (int i = 0; i < size; i++) {
+    const float x = static_cast<float>(i) / static_cast<float>(size - 1);
+    if (x < rampUpEnd) {
+      table[i] = x / rampUpEnd;
+    } else if (x > rampDownStart) {
+      table[i] = (1.0f - x) / (1.0f - rampDownStart);
     } else {
-      lut.push_back(1.0f);
+      table[i] = 1.0f;
     }
   }
-  juce::FloatVectorOperations::clip(lut.data(), lut.data(), 0.0f, 1.0f, lut.size());
+  juce::FloatVectorOperations::clip(table, table, 0.0f, 1.0f, size);
+}
+
+[[maybe_unused]] static const std::vector<float> getGrainEnvelopeLUT(const float shape, const float tilt) {
+  std::vector<float> lut(ENV_LUT_SIZE);
+  fillGrainEnvelope(lut.data(), ENV_LUT_SIZE, shape, tilt);
   return lut;
 }
 
+// Channel 0 of a mono buffer as is, otherwise the average of every channel mixed into mono, which is used as the storage
+static inline const float* getMonoReadPointer(const juce::AudioBuffer<float>& buffer, std::vector<float>& mono) {
+  const int numChannels = buffer.getNumChannels();
+  const int numSamples = buffer.getNumSamples();
+  if (numChannels <= 1) return buffer.getReadPointer(0);
+  mono.resize(static_cast<size_t>(numSamples));
+  const float gain = 1.0f / static_cast<float>(numChannels);
+  juce::FloatVectorOperations::copyWithMultiply(mono.data(), buffer.getReadPointer(0), gain, numSamples);
+  for (int c = 1; c < numChannels; c++) {
+    juce::FloatVectorOperations::addWithMultiply(mono.data(), buffer.getReadPointer(c), gain, numSamples);
+  }
+  return mono.data();
+}
+
 static inline float db2lin(float value) { return std::pow(10.0f, value / 10.0f); }
 static inline float lin2db(float value) { return value < 1e-10 ? -100 : 10.0f * std::log10(value); }
 
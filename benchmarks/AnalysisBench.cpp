@@ -0,0 +1,461 @@
+/*
+  ==============================================================================
+
+    AnalysisBench.cpp
+    Created: 19 Oct 2026 3:37:12am
+
+    Times every stage of the analysis run when a file is loaded (spectrogram
+    FFT, pitch FFT, HPCP, pitch segmenting, transients) on generated clips
+    with a known answer, and checks how much of that answer was found so a
+    faster stage can be told apart from a worse one.
+
+  ==============================================================================
+*/
+
+#include <juce_audio_utils/juce_audio_utils.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include "DSP/GranularSynth.h"
+#include "DSP/PitchDetector.h"
+#include "DSP/TransientDetector.h"
+#include "Utils/FastRandom.h"
+
+namespace {
+// Live bytes allocated with new and the most there have been since the last reset. Each block carries its size in a header in
+// front of it, a full max_align_t so what is handed out stays aligned.
+constexpr std::size_t HEADER_SIZE = alignof(std::max_align_t);
+std::atomic<std::size_t> gLiveBytes{0};
+std::atomic<std::size_t> gPeakBytes{0};
+}  // namespace
+
+void* operator new(std::size_t size) {
+  void* block = std::malloc(size + HEADER_SIZE);
+  if (block == nullptr) throw std::bad_alloc();
+  *static_cast<std::size_t*>(block) = size;
+  const std::size_t live = gLiveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+  std::size_t peak = gPeakBytes.load(std::memory_order_relaxed);
+  while (live > peak && !gPeakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+  }
+  return static_cast<char*>(block) + HEADER_SIZE;
+}
+void operator delete(void* ptr) noexcept {
+  if (ptr == nullptr) return;
+  void* block = static_cast<char*>(ptr) - HEADER_SIZE;
+  gLiveBytes.fetch_sub(*static_cast<std::size_t*>(block), std::memory_order_relaxed);
+  std::free(block);
+}
+void operator delete(void* ptr, std::size_t) noexcept { operator delete(ptr); }
+
+namespace {
+
+constexpr double ONSET_TOLERANCE_SEC = 0.05;  // A transient this close to an onset found it
+constexpr double MIN_COVERAGE_SEC = 0.1;      // How much of a note a detection has to overlap to count as finding it
+constexpr double FADE_SEC = 0.005;            // Segment edges, so only the intended onsets are clicks
+constexpr float NOISE_GAIN = 0.3f;
+
+enum class Kind { CHORD, SWEEP, NOISE, SILENCE, NUM_KINDS };
+const char* KIND_NAMES[] = {"chord", "sweep", "noise", "silence"};
+
+// One stretch of a generated clip and what a perfect analysis would say about it
+struct Segment {
+  Kind kind;
+  double start;
+  double end;
+  double pitchedStart;  // Sweeps only have a pitch once they've landed on their note
+  std::vector<int> midiNotes;
+
+  bool hasPitchClass(int pitchClass) const {
+    for (int note : midiNotes) {
+      if (note % 12 == pitchClass) return true;
+    }
+    return false;
+  }
+};
+
+struct Clip {
+  double sampleRate;
+  double seconds;
+  juce::AudioBuffer<float> audio;
+  std::vector<Segment> segments;
+};
+
+struct Options {
+  std::vector<double> lengths{10.0, 60.0, 180.0};
+  std::vector<double> sampleRates{44100.0, 48000.0, 96000.0};
+  juce::int64 seed = 1;
+  juce::String jsonPath;  // "-" prints the JSON instead of the table
+  juce::File corpusDir;   // Also writes the clips here when set
+};
+
+void printUsage() {
+  std::cout << "Usage: gRainbowAnalysisBench [options]\n"
+               "\n"
+               "  --lengths <list>    Clip lengths in seconds (default 10,60,180)\n"
+               "  --rates <list>      Sample rates (default 44100,48000,96000)\n"
+               "  --seed <n>          Seed the clips are generated from (default 1)\n"
+               "  --corpus <dir>      Also write the generated clips as .wav files\n"
+               "  --json <file|->     Write the results as JSON, - prints them instead of the table\n";
+}
+
+bool parseList(const juce::String& value, std::vector<double>& out) {
+  out.clear();
+  for (const juce::String& item : juce::StringArray::fromTokens(value, ",", "")) {
+    const double number = item.trim().getDoubleValue();
+    if (number <= 0.0) return false;
+    out.push_back(number);
+  }
+  return !out.empty();
+}
+
+bool parseOptions(const juce::StringArray& args, Options& options) {
+  for (int i = 0; i < args.size(); ++i) {
+    const juce::String& arg = args[i];
+    if (arg == "--help" || arg == "-h" || i + 1 >= args.size()) return false;
+    const juce::String value = args[++i];
+    bool valid = true;
+    if (arg == "--lengths") {
+      valid = parseList(value, options.lengths);
+    } else if (arg == "--rates") {
+      valid = parseList(value, options.sampleRates);
+    } else if (arg == "--seed") {
+      options.seed = value.getLargeIntValue();
+    } else if (arg == "--corpus") {
+      options.corpusDir = juce::File::getCurrentWorkingDirectory().getChildFile(value);
+    } else if (arg == "--json") {
+      options.jsonPath = value;
+    } else {
+      std::cerr << "Unknown option " << arg << "\n";
+      return false;
+    }
+    if (!valid) {
+      std::cerr << "Invalid value for " << arg << ": " << value << "\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+double midiToHz(double midiNote) { return 440.0 * std::pow(2.0, (midiNote - 69.0) / 12.0); }
+
+// Random picks in the pitch range the detector looks at
+int randomNote(Utils::FastRandom& random, int low, int high) {
+  return low + static_cast<int>(random.nextFloat() * static_cast<float>(high - low + 1));
+}
+
+/**
+ * @brief A clip of chords of pure sines, sung sounding harmonic tones gliding onto a note with vibrato, noise bursts and
+ * silence, in random order. Pitched material stays inside the range the pitch detector searches.
+ */
+Clip generateClip(double seconds, double sampleRate, juce::int64 seed) {
+  Clip clip;
+  clip.sampleRate = sampleRate;
+  clip.seconds = seconds;
+  const int numSamples = static_cast<int>(seconds * sampleRate);
+  clip.audio.setSize(1, numSamples);
+  clip.audio.clear();
+  float* out = clip.audio.getWritePointer(0);
+
+  Utils::FastRandom random(static_cast<uint64_t>(seed) ^ Utils::FastRandom::mix(static_cast<uint64_t>(sampleRate * seconds)));
+  const double twoPi = juce::MathConstants<double>::twoPi;
+  int lastSweepNote = 60;
+  double t = 0.0;
+  while (t < seconds) {
+    Segment segment;
+    const float pick = random.nextFloat();
+    segment.kind = (pick < 0.35f) ? Kind::CHORD : (pick < 0.7f) ? Kind::SWEEP : (pick < 0.85f) ? Kind::NOISE : Kind::SILENCE;
+    const bool pitched = segment.kind == Kind::CHORD || segment.kind == Kind::SWEEP;
+    const double length = pitched ? 0.8 + 1.2 * random.nextFloat() : 0.2 + 0.3 * random.nextFloat();
+    segment.start = t;
+    segment.end = juce::jmin(seconds, t + length);
+    segment.pitchedStart = segment.start;
+    t = segment.end;
+
+    const int start = static_cast<int>(segment.start * sampleRate);
+    const int end = static_cast<int>(segment.end * sampleRate);
+    const int fade = static_cast<int>(FADE_SEC * sampleRate);
+    const auto envelope = [start, end, fade](int i) {
+      return static_cast<float>(juce::jmin(1.0, juce::jmin(i - start, end - 1 - i) / static_cast<double>(fade)));
+    };
+
+    if (segment.kind == Kind::CHORD) {
+      // Triad with the root loudest, so there is one clear pitch to track
+      const int root = randomNote(random, PitchDetector::MIN_MIDINOTE + 5, PitchDetector::MAX_MIDINOTE - 24);
+      segment.midiNotes = {root, root + (random.nextBool() ? 4 : 3), root + 7};
+      const float gains[] = {0.5f, 0.25f, 0.25f};
+      for (size_t n = 0; n < segment.midiNotes.size(); ++n) {
+        const double step = twoPi * midiToHz(segment.midiNotes[n]) / sampleRate;
+        for (int i = start; i < end; ++i) {
+          out[i] += gains[n] * envelope(i) * static_cast<float>(std::sin(step * (i - start)));
+        }
+      }
+    } else if (segment.kind == Kind::SWEEP) {
+      // Glides from the last sung note for the first quarter, then holds with vibrato
+      const int target = randomNote(random, PitchDetector::MIN_MIDINOTE + 5, PitchDetector::MAX_MIDINOTE - 12);
+      segment.midiNotes = {target};
+      segment.pitchedStart = segment.start + 0.25 * (segment.end - segment.start);
+      const int glideEnd = static_cast<int>(segment.pitchedStart * sampleRate);
+      double phase = 0.0;
+      for (int i = start; i < end; ++i) {
+        const double glide = juce::jmin(1.0, static_cast<double>(i - start) / static_cast<double>(juce::jmax(1, glideEnd - start)));
+        const double vibrato = (i >= glideEnd) ? 0.3 * std::sin(twoPi * 5.5 * (i - glideEnd) / sampleRate) : 0.0;
+        phase += twoPi * midiToHz(lastSweepNote + (target - lastSweepNote) * glide + vibrato) / sampleRate;
+        double sample = 0.0;
+        // Falling harmonics with a bump around the third, roughly a vowel
+        for (int h = 1; h <= 10; ++h) sample += std::sin(phase * h) * (h == 3 ? 0.6 : 1.0 / h);
+        out[i] += 0.3f * envelope(i) * static_cast<float>(sample);
+      }
+      lastSweepNote = target;
+    } else if (segment.kind == Kind::NOISE) {
+      for (int i = start; i < end; ++i) out[i] += NOISE_GAIN * envelope(i) * (2.0f * random.nextFloat() - 1.0f);
+    }
+    clip.segments.push_back(segment);
+  }
+  return clip;
+}
+
+// How much of what the clip holds the pitch detector found
+struct PitchScore {
+  double precision = 0.0;         // Share of detected time with the right pitch class
+  double recall = 0.0;            // Share of pitched segments found
+  double unpitchedSeconds = 0.0;  // Detections over noise and silence
+  std::array<int, static_cast<size_t>(Kind::NUM_KINDS)> found{};
+  std::array<int, static_cast<size_t>(Kind::NUM_KINDS)> total{};
+};
+
+PitchScore scorePitches(const Clip& clip, PitchDetector::PitchMap& pitchMap) {
+  PitchScore score;
+  double correct = 0.0;
+  double wrong = 0.0;
+  std::vector<double> coverage(clip.segments.size(), 0.0);
+  for (Utils::PitchClass pitchClass : Utils::ALL_PITCH_CLASS) {
+    for (const PitchDetector::Pitch& pitch : pitchMap.getReference(pitchClass)) {
+      const double start = pitch.posRatio * clip.seconds;
+      const double end = start + pitch.duration * clip.seconds;
+      for (size_t s = 0; s < clip.segments.size(); ++s) {
+        const Segment& segment = clip.segments[s];
+        const double overlap = juce::jmin(end, segment.end) - juce::jmax(start, segment.pitchedStart);
+        if (overlap <= 0.0) continue;
+        if (segment.midiNotes.empty()) {
+          score.unpitchedSeconds += overlap;
+        } else if (segment.hasPitchClass(static_cast<int>(pitch.pitchClass))) {
+          correct += overlap;
+          coverage[s] += overlap;
+        } else {
+          wrong += overlap;
+        }
+      }
+    }
+  }
+
+  int numPitched = 0;
+  int numFound = 0;
+  for (size_t s = 0; s < clip.segments.size(); ++s) {
+    const size_t kind = static_cast<size_t>(clip.segments[s].kind);
+    if (clip.segments[s].midiNotes.empty()) continue;
+    const bool found = coverage[s] >= MIN_COVERAGE_SEC;
+    score.total[kind]++;
+    score.found[kind] += found ? 1 : 0;
+    numPitched++;
+    numFound += found ? 1 : 0;
+  }
+  const double detected = correct + wrong + score.unpitchedSeconds;
+  score.precision = (detected > 0.0) ? correct / detected : 0.0;
+  score.recall = (numPitched > 0) ? static_cast<double>(numFound) / numPitched : 0.0;
+  return score;
+}
+
+// Onsets are every start of something that isn't silence
+void scoreTransients(const Clip& clip, const std::vector<TransientDetector::Transient>& transients, double& precision,
+                     double& recall) {
+  std::vector<double> onsets;
+  for (const Segment& segment : clip.segments) {
+    if (segment.kind != Kind::SILENCE && segment.start > 0.0) onsets.push_back(segment.start);
+  }
+  int hits = 0;
+  for (double onset : onsets) {
+    for (const TransientDetector::Transient& transient : transients) {
+      if (std::abs(transient.posRatio * clip.seconds - onset) <= ONSET_TOLERANCE_SEC) {
+        hits++;
+        break;
+      }
+    }
+  }
+  int matched = 0;
+  for (const TransientDetector::Transient& transient : transients) {
+    for (double onset : onsets) {
+      if (std::abs(transient.posRatio * clip.seconds - onset) <= ONSET_TOLERANCE_SEC) {
+        matched++;
+        break;
+      }
+    }
+  }
+  precision = transients.empty() ? 0.0 : static_cast<double>(matched) / static_cast<double>(transients.size());
+  recall = onsets.empty() ? 0.0 : static_cast<double>(hits) / static_cast<double>(onsets.size());
+}
+
+// Runs one stage, recording its time and how far the heap grew above where it started
+template <typename StageFn>
+juce::DynamicObject::Ptr timeStage(const char* name, const Clip& clip, StageFn&& stage) {
+  const std::size_t startBytes = gLiveBytes.load();
+  gPeakBytes.store(startBytes);
+  const juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+  const size_t frames = stage();
+  const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+  juce::DynamicObject::Ptr result = new juce::DynamicObject();
+  result->setProperty("stage", name);
+  result->setProperty("seconds", seconds);
+  result->setProperty("frames", static_cast<juce::int64>(frames));
+  result->setProperty("framesPerSecond", seconds > 0.0 ? static_cast<double>(frames) / seconds : 0.0);
+  result->setProperty("realtimeFactor", seconds > 0.0 ? clip.seconds / seconds : 0.0);
+  result->setProperty("peakHeapMB", static_cast<double>(gPeakBytes.load() - startBytes) / (1024.0 * 1024.0));
+  return result;
+}
+
+juce::var runClip(const Clip& clip, bool printTable) {
+  juce::Array<juce::var> stages;
+
+  // Spectrogram shown in the editor, the same settings the synth runs it with
+  {
+    Fft fft(GranularSynth::FFT_SIZE, GranularSynth::HOP_SIZE, 0.0, 1.0);
+    stages.add(juce::var(timeStage("spectrogram fft", clip, [&]() {
+      fft.processSync(&clip.audio);
+      return fft.getSpectrum().size();
+    }).get()));
+  }
+
+  PitchDetector pitchDetector(0.0, 1.0);
+  stages.add(juce::var(timeStage("pitch fft", clip, [&]() {
+    pitchDetector.computeSpectrum(&clip.audio, clip.sampleRate);
+    return pitchDetector.getSpectrum().size();
+  }).get()));
+  stages.add(juce::var(timeStage("hpcp", clip, [&]() {
+    pitchDetector.computeHPCP();
+    return pitchDetector.getHPCP().size();
+  }).get()));
+  stages.add(juce::var(timeStage("segment pitches", clip, [&]() {
+    pitchDetector.segmentPitches();
+    return pitchDetector.getHPCP().size();
+  }).get()));
+  const PitchScore pitchScore = scorePitches(clip, pitchDetector.getPitches());
+  pitchDetector.clear();
+
+  TransientDetector transientDetector(0.0, 1.0);
+  stages.add(juce::var(timeStage("transient fft", clip, [&]() {
+    transientDetector.computeSpectrum(&clip.audio);
+    return transientDetector.getSpectrum().size();
+  }).get()));
+  stages.add(juce::var(timeStage("transients", clip, [&]() {
+    transientDetector.retrieveTransients();
+    return transientDetector.getSpectrum().size();
+  }).get()));
+  double transientPrecision = 0.0;
+  double transientRecall = 0.0;
+  scoreTransients(clip, transientDetector.getTransients(), transientPrecision, transientRecall);
+
+  juce::DynamicObject::Ptr result = new juce::DynamicObject();
+  result->setProperty("seconds", clip.seconds);
+  result->setProperty("sampleRate", clip.sampleRate);
+  result->setProperty("stages", stages);
+  result->setProperty("pitchPrecision", pitchScore.precision);
+  result->setProperty("pitchRecall", pitchScore.recall);
+  result->setProperty("pitchUnpitchedSeconds", pitchScore.unpitchedSeconds);
+  for (size_t kind = 0; kind < static_cast<size_t>(Kind::NUM_KINDS); ++kind) {
+    if (pitchScore.total[kind] == 0) continue;
+    result->setProperty(juce::String(KIND_NAMES[kind]) + "Recall",
+                        static_cast<double>(pitchScore.found[kind]) / static_cast<double>(pitchScore.total[kind]));
+  }
+  result->setProperty("transientPrecision", transientPrecision);
+  result->setProperty("transientRecall", transientRecall);
+
+  if (printTable) {
+    std::cout << juce::String(clip.seconds, 0) << " s at " << juce::String(clip.sampleRate, 0) << " Hz\n";
+    for (const juce::var& stage : stages) {
+      std::cout << "  " << stage["stage"].toString().paddedRight(' ', 16) << juce::String(static_cast<double>(stage["seconds"]), 3)
+                << " s  " << juce::String(static_cast<double>(stage["framesPerSecond"]), 0).paddedLeft(' ', 9) << " frames/s  "
+                << juce::String(static_cast<double>(stage["realtimeFactor"]), 1).paddedLeft(' ', 7) << "x real time  "
+                << juce::String(static_cast<double>(stage["peakHeapMB"]), 1) << " MB peak\n";
+    }
+    std::cout << "  pitches: precision " << juce::String(pitchScore.precision, 3) << ", recall "
+              << juce::String(pitchScore.recall, 3) << ", " << juce::String(pitchScore.unpitchedSeconds, 2)
+              << " s over noise/silence\n"
+              << "  transients: precision " << juce::String(transientPrecision, 3) << ", recall "
+              << juce::String(transientRecall, 3) << "\n";
+  }
+  return juce::var(result.get());
+}
+
+Utils::Result writeClip(const Clip& clip, const juce::File& dir) {
+  const juce::String name = "clip_" + juce::String(clip.seconds, 0) + "s_" + juce::String(clip.sampleRate, 0) + "Hz.wav";
+  const juce::File file = dir.getChildFile(name);
+  file.deleteFile();
+  std::unique_ptr<juce::FileOutputStream> outStream = file.createOutputStream();
+  if (outStream == nullptr) return {false, "Could not create " + file.getFullPathName()};
+  juce::WavAudioFormat wav;
+  std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(outStream.get(), clip.sampleRate, 1, 24, {}, 0));
+  if (writer == nullptr) return {false, "Could not write " + file.getFullPathName()};
+  outStream.release();
+  writer->writeFromAudioSampleBuffer(clip.audio, 0, clip.audio.getNumSamples());
+  return {true, ""};
+}
+
+int runBenchmark(const Options& options) {
+  if (options.corpusDir != juce::File() && !options.corpusDir.createDirectory()) {
+    std::cerr << "Could not create " << options.corpusDir.getFullPathName() << "\n";
+    return 1;
+  }
+  const bool printTable = options.jsonPath != "-";
+  juce::Array<juce::var> clipResults;
+  for (double sampleRate : options.sampleRates) {
+    for (double seconds : options.lengths) {
+      const Clip clip = generateClip(seconds, sampleRate, options.seed);
+      if (options.corpusDir != juce::File()) {
+        Utils::Result result = writeClip(clip, options.corpusDir);
+        if (!result.success) {
+          std::cerr << result.message << "\n";
+          return 1;
+        }
+      }
+      clipResults.add(runClip(clip, printTable));
+    }
+  }
+
+  if (options.jsonPath.isNotEmpty()) {
+    juce::DynamicObject::Ptr root = new juce::DynamicObject();
+    root->setProperty("seed", options.seed);
+    root->setProperty("clips", clipResults);
+    const juce::String json = juce::JSON::toString(juce::var(root.get()));
+    if (options.jsonPath == "-") {
+      std::cout << json << std::endl;
+    } else if (!juce::File::getCurrentWorkingDirectory().getChildFile(options.jsonPath).replaceWithText(json)) {
+      std::cerr << "Could not write " << options.jsonPath << "\n";
+      return 1;
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  juce::StringArray args;
+  for (int i = 1; i < argc; ++i) args.add(juce::String::fromUTF8(argv[i]));
+
+  Options options;
+  if (!parseOptions(args, options)) {
+    printUsage();
+    return 2;
+  }
+
+  juce::ScopedJuceInitialiser_GUI juceInitialiser;
+  return runBenchmark(options);
+}
@@ -0,0 +1,518 @@
+/*
+  ==============================================================================
+
+    ProcessBlockBench.cpp
+    Created: 19 Oct 2026 2:51:37am
+
+    Runs GranularSynth::processBlock over a sweep of voice counts, generators,
+    filters, sync and block sizes on a synthetic source and reports ns/sample,
+    worst case block time and allocations per block, optionally as JSON. Can
+    also render every case with two engine configurations and check they give
+    the same samples.
+
+  ==============================================================================
+*/
+
+#include <juce_audio_utils/juce_audio_utils.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <vector>
+
+#include "DSP/GranularSynth.h"
+#include "Utils/FastRandom.h"
+#include "Utils/RtCheck.h"
+
+namespace {
+// Every operator new on any thread while a block is being processed, render workers included
+std::atomic<bool> gCountAllocations{false};
+std::atomic<juce::int64> gAllocations{0};
+}  // namespace
+
+// The array and nothrow forms all end up here, so these two are enough to see every allocation made with new
+void* operator new(std::size_t size) {
+  if (gCountAllocations.load(std::memory_order_relaxed)) gAllocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+  throw std::bad_alloc();
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace {
+
+constexpr double DEFAULT_SAMPLE_RATE = 48000.0;
+constexpr double DEFAULT_SECONDS = 2.0;
+constexpr double DEFAULT_WARMUP_SECONDS = 0.25;  // Not timed, covers the first grains' attack
+constexpr double DEFAULT_TOLERANCE = 1e-5;
+constexpr double SOURCE_SECONDS = 8.0;
+constexpr double RETRIGGER_SECONDS = 0.25;  // How often the retrigger pattern strikes its chord again
+constexpr int FIRST_NOTE = 48;
+constexpr int NOTE_SPACING = 5;  // Fourths, so 12 voices still land on 12 different pitch classes
+constexpr int SOURCE_TIMEOUT_MS = 60000;
+
+enum class Pattern { HELD, RETRIGGER };
+
+// Engine setup a case is rendered with
+struct KernelConfig {
+  int threads = 1;
+  int interpolation = static_cast<int>(Interpolation::Quality::LINEAR);
+  int oversampling = 1;  // Above 1 renders through the offline bounce path, which also reads grains with sinc interpolation
+
+  juce::String toString() const {
+    return "threads=" + juce::String(threads) + ",interpolation=" + juce::String(interpolation) +
+           ",oversampling=" + juce::String(oversampling);
+  }
+};
+
+struct Case {
+  int voices;
+  int generators;
+  bool filter;
+  bool sync;
+  int blockSize;
+  Pattern pattern;
+
+  juce::String toString() const {
+    return "voices " + juce::String(voices).paddedLeft(' ', 2) + "  gens " + juce::String(generators) + "  filter " +
+           (filter ? "on " : "off") + "  sync " + (sync ? "on " : "off") + "  block " + juce::String(blockSize).paddedLeft(' ', 4) +
+           (pattern == Pattern::HELD ? "  held     " : "  retrigger");
+  }
+};
+
+struct Options {
+  std::vector<int> voices{1, 4, 12};
+  std::vector<int> generators{1, 2, 3, 4};
+  std::vector<int> filters{0, 1};
+  std::vector<int> sync{0, 1};
+  std::vector<int> blockSizes{32, 128, 512, 2048};
+  std::vector<Pattern> patterns{Pattern::HELD};
+  double sampleRate = DEFAULT_SAMPLE_RATE;
+  double seconds = DEFAULT_SECONDS;
+  double warmupSeconds = DEFAULT_WARMUP_SECONDS;
+  juce::int64 seed = 1;
+  KernelConfig config;
+  bool compare = false;
+  KernelConfig compareConfig;
+  double tolerance = DEFAULT_TOLERANCE;
+  juce::String jsonPath;  // "-" prints the JSON instead of the table
+  bool rtStrict = false;
+};
+
+struct Run {
+  std::vector<double> blockSeconds;  // Timed blocks only
+  juce::int64 timedSamples = 0;
+  juce::int64 allocations = 0;
+  juce::int64 maxBlockAllocations = 0;
+  int rtViolations = 0;  // Only counted in a GRAINBOW_RT_CHECK build
+  int numBlocks = 0;
+  juce::AudioBuffer<float> output;  // Only kept when comparing
+};
+
+void printUsage() {
+  std::cout << "Usage: gRainbowBench [options]\n"
+               "\n"
+               "  --voices <list>       Voices held at once (default 1,4,12)\n"
+               "  --gens <list>         Generators playing per voice (default 1,2,3,4)\n"
+               "  --filters <list>      off,on (default both)\n"
+               "  --sync <list>         off,on (default both)\n"
+               "  --blocks <list>       Block sizes (default 32,128,512,2048)\n"
+               "  --patterns <list>     held,retrigger (default held)\n"
+               "  --rate <hz>           Sample rate (default 48000)\n"
+               "  --seconds <s>         Audio rendered per case (default 2)\n"
+               "  --warmup <s>          Leading audio left out of the timings (default 0.25)\n"
+               "  --seed <n>            Project seed, every case renders deterministically (default 1)\n"
+               "  --config <k=v,...>    Engine setup: threads, interpolation (0 linear, 1 cubic, 2 sinc), oversampling (1, 2, 4)\n"
+               "  --compare <k=v,...>   Also render every case with these changes to --config and check the samples match\n"
+               "  --tolerance <x>       Largest sample difference --compare accepts (default 1e-5)\n"
+               "  --json <file|->       Write the results as JSON, - prints them instead of the table\n"
+               "  --rt-strict           Fail if processBlock allocates or locks, needs a GRAINBOW_RT_CHECK build\n";
+}
+
+bool parseIntList(const juce::String& value, std::vector<int>& out) {
+  out.clear();
+  for (const juce::String& item : juce::StringArray::fromTokens(value, ",", "")) {
+    const juce::String token = item.trim();
+    if (token == "on") out.push_back(1);
+    else if (token == "off") out.push_back(0);
+    else if (token.containsOnly("0123456789") && token.isNotEmpty()) out.push_back(token.getIntValue());
+    else return false;
+  }
+  return !out.empty();
+}
+
+bool parseConfig(const juce::String& value, KernelConfig& config) {
+  for (const juce::String& item : juce::StringArray::fromTokens(value, ",", "")) {
+    const juce::String key = item.upToFirstOccurrenceOf("=", false, false).trim();
+    const int number = item.fromFirstOccurrenceOf("=", false, false).trim().getIntValue();
+    if (key == "threads" && number >= 1) config.threads = number;
+    else if (key == "interpolation" && number >= 0 && number < static_cast<int>(Interpolation::Quality::COUNT))
+      config.interpolation = number;
+    else if (key == "oversampling" && (number == 1 || number == 2 || number == 4)) config.oversampling = number;
+    else return false;
+  }
+  return true;
+}
+
+bool parseOptions(const juce::StringArray& args, Options& options) {
+  for (int i = 0; i < args.size(); ++i) {
+    const juce::String& arg = args[i];
+    if (arg == "--rt-strict") {
+      options.rtStrict = true;
+      continue;
+    }
+    if (arg == "--help" || arg == "-h" || i + 1 >= args.size()) return false;
+    const juce::String value = args[++i];
+    bool valid = true;
+    if (arg == "--voices") {
+      valid = parseIntList(value, options.voices);
+      for (int voices : options.voices) valid = valid && voices >= 1 && voices <= ParamEngine::MAX_VOICES;
+    } else if (arg == "--gens") {
+      valid = parseIntList(value, options.generators);
+      for (int gens : options.generators) valid = valid && gens >= 1 && gens <= NUM_GENERATORS;
+    } else if (arg == "--filters") {
+      valid = parseIntList(value, options.filters);
+    } else if (arg == "--sync") {
+      valid = parseIntList(value, options.sync);
+    } else if (arg == "--blocks") {
+      valid = parseIntList(value, options.blockSizes);
+      for (int blockSize : options.blockSizes) valid = valid && blockSize >= 1;
+    } else if (arg == "--patterns") {
+      options.patterns.clear();
+      for (const juce::String& item : juce::StringArray::fromTokens(value, ",", "")) {
+        if (item.trim() == "held") options.patterns.push_back(Pattern::HELD);
+        else if (item.trim() == "retrigger") options.patterns.push_back(Pattern::RETRIGGER);
+        else valid = false;
+      }
+      valid = valid && !options.patterns.empty();
+    } else if (arg == "--rate") {
+      options.sampleRate = value.getDoubleValue();
+      valid = options.sampleRate > 0.0;
+    } else if (arg == "--seconds") {
+      options.seconds = value.getDoubleValue();
+      valid = options.seconds > 0.0;
+    } else if (arg == "--warmup") {
+      options.warmupSeconds = value.getDoubleValue();
+      valid = options.warmupSeconds >= 0.0;
+    } else if (arg == "--seed") {
+      options.seed = value.getLargeIntValue();
+    } else if (arg == "--config") {
+      valid = parseConfig(value, options.config);
+    } else if (arg == "--compare") {
+      options.compare = true;
+      options.compareConfig = options.config;
+      valid = parseConfig(value, options.compareConfig);
+    } else if (arg == "--tolerance") {
+      options.tolerance = value.getDoubleValue();
+    } else if (arg == "--json") {
+      options.jsonPath = value;
+    } else {
+      std::cerr << "Unknown option " << arg << "\n";
+      return false;
+    }
+    if (!valid) {
+      std::cerr << "Invalid value for " << arg << ": " << value << "\n";
+      return false;
+    }
+  }
+  if (options.rtStrict && !Utils::RtCheck::IS_ACTIVE) {
+    std::cerr << "--rt-strict needs a build configured with -DGRAINBOW_RT_CHECK=ON on Linux\n";
+    return false;
+  }
+  return true;
+}
+
+// A few seconds of slowly gliding harmonic tones with a bit of noise, different on each side so both channels get read
+Utils::Result writeSource(const juce::File& file, double sampleRate) {
+  const int numSamples = static_cast<int>(SOURCE_SECONDS * sampleRate);
+  juce::AudioBuffer<float> source(2, numSamples);
+  Utils::FastRandom random(0);
+  const double twoPi = juce::MathConstants<double>::twoPi;
+  for (int ch = 0; ch < 2; ++ch) {
+    float* out = source.getWritePointer(ch);
+    double phase = 0.0;
+    for (int i = 0; i < numSamples; ++i) {
+      const double t = static_cast<double>(i) / sampleRate;
+      // Walks up an octave over the length of the source so every note finds something near its pitch
+      const double freq = 110.0 * std::pow(2.0, t / SOURCE_SECONDS) * (ch == 0 ? 1.0 : 1.003);
+      phase += twoPi * freq / sampleRate;
+      double sample = 0.0;
+      for (int harmonic = 1; harmonic <= 8; ++harmonic) sample += std::sin(phase * harmonic) / harmonic;
+      out[i] = static_cast<float>(0.25 * sample) + 0.01f * (random.nextFloat() - 0.5f);
+    }
+  }
+
+  file.deleteFile();
+  std::unique_ptr<juce::FileOutputStream> outStream = file.createOutputStream();
+  if (outStream == nullptr) return {false, "Could not create " + file.getFullPathName()};
+  juce::WavAudioFormat wav;
+  std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(outStream.get(), sampleRate, 2, 32, {}, 0));
+  if (writer == nullptr) return {false, "Could not write the source"};
+  outStream.release();
+  writer->writeFromAudioSampleBuffer(source, 0, numSamples);
+  return {true, ""};
+}
+
+std::unique_ptr<GranularSynth> createSynth(const Options& options, const Case& c, const KernelConfig& config,
+                                           const juce::File& source) {
+  std::unique_ptr<GranularSynth> synth = std::make_unique<GranularSynth>();
+  ParamEngine& engine = synth->getParams().engine;
+  // Timings are of the whole cloud, and the same case has to give the same samples every time it is rendered
+  engine.deterministic.store(true);
+  engine.seed.store(options.seed);
+  engine.loadGovernor.store(false);
+  engine.missThreshold.store(0.0f);  // Slow cases are expected here, they aren't worth logging
+  engine.maxVoices.store(ParamEngine::MAX_VOICES);
+  engine.interpolation.store(config.interpolation);
+  engine.offlineOversampling.store(config.oversampling);
+  engine.offlineQuality.store(config.oversampling > 1);
+  synth->setNonRealtime(config.oversampling > 1);
+  synth->setNumRenderThreads(config.threads);
+  synth->setRateAndBufferSizeDetails(options.sampleRate, c.blockSize);
+  synth->prepareToPlay(options.sampleRate, c.blockSize);
+
+  Utils::Result result = synth->loadAudioFile(source, false);
+  if (!result.success) {
+    std::cerr << result.message << "\n";
+    return nullptr;
+  }
+  const juce::uint32 waitStart = juce::Time::getMillisecondCounter();
+  while (!synth->isSourceReady()) {
+    if (juce::Time::getMillisecondCounter() - waitStart > SOURCE_TIMEOUT_MS) return nullptr;
+    juce::Thread::sleep(1);
+  }
+
+  // Stands in for the pitch analysis: spread out positions, some transposed far enough to read the decimated levels
+  for (auto& note : synth->getParamsNote().notes) {
+    note->candidates.clear();
+    for (int k = 0; k < MAX_CANDIDATES; ++k) {
+      const float posRatio = std::fmod(0.07f * static_cast<float>(note->noteIdx) + 0.13f * static_cast<float>(k), 0.9f);
+      const float pbRate = std::pow(Utils::TIMESTRETCH_RATIO, static_cast<float>((k * 5) % 19 - 6));
+      note->candidates.push_back(ParamCandidate(posRatio, pbRate, 0.1f, 1.0f));
+    }
+    note->setStartingCandidatePosition();
+    for (int g = 0; g < NUM_GENERATORS; ++g) ParamHelper::setParam(note->generators[g]->enable, g < c.generators);
+  }
+  ParamGlobal& global = synth->getParamGlobal();
+  ParamHelper::setCommonParam(&global, ParamCommon::Type::FILT_TYPE,
+                              static_cast<int>(c.filter ? Utils::FilterType::LOWPASS : Utils::FilterType::NO_FILTER));
+  ParamHelper::setCommonParam(&global, ParamCommon::Type::GRAIN_SYNC, c.sync);
+  synth->getParamUI().specComplete = true;
+  return synth;
+}
+
+void fillMidi(const Case& c, juce::int64 blockStart, int numSamples, double sampleRate, juce::MidiBuffer& midi) {
+  midi.clear();
+  // Held chords are struck once at the start, retriggered ones again every period
+  const juce::int64 period = (c.pattern == Pattern::HELD) ? (blockStart + numSamples + 1)
+                                                           : static_cast<juce::int64>(RETRIGGER_SECONDS * sampleRate);
+  for (juce::int64 strike = ((blockStart + period - 1) / period) * period; strike < blockStart + numSamples; strike += period) {
+    const int offset = static_cast<int>(strike - blockStart);
+    for (int v = 0; v < c.voices; ++v) {
+      const int midiNote = FIRST_NOTE + v * NOTE_SPACING;
+      if (strike > 0) midi.addEvent(juce::MidiMessage::noteOff(1, midiNote), offset);
+      midi.addEvent(juce::MidiMessage::noteOn(1, midiNote, 0.8f), offset);
+    }
+  }
+}
+
+bool runCase(const Options& options, const Case& c, const KernelConfig& config, const juce::File& source, bool keepOutput,
+             Run& run) {
+  std::unique_ptr<GranularSynth> synth = createSynth(options, c, config, source);
+  if (synth == nullptr) return false;
+
+  const int numChannels = synth->getTotalNumOutputChannels();
+  const juce::int64 warmupSamples = static_cast<juce::int64>(options.warmupSeconds * options.sampleRate);
+  const juce::int64 totalSamples = warmupSamples + static_cast<juce::int64>(options.seconds * options.sampleRate);
+  run.numBlocks = static_cast<int>((totalSamples + c.blockSize - 1) / c.blockSize);
+  run.blockSeconds.reserve(static_cast<size_t>(run.numBlocks));
+  if (keepOutput) run.output.setSize(numChannels, static_cast<int>(totalSamples));
+
+  juce::AudioBuffer<float> buffer(numChannels, c.blockSize);
+  juce::MidiBuffer midi;
+  midi.ensureSize(static_cast<size_t>(c.voices) * 32);
+  const int rtViolationsBefore = Utils::RtCheck::getNumViolations();
+  for (int block = 0; block < run.numBlocks; ++block) {
+    const juce::int64 blockStart = static_cast<juce::int64>(block) * c.blockSize;
+    const int numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(c.blockSize), totalSamples - blockStart));
+    fillMidi(c, blockStart, numSamples, options.sampleRate, midi);
+    buffer.setSize(numChannels, numSamples, false, false, true);
+    buffer.clear();
+
+    const juce::int64 allocationsBefore = gAllocations.load();
+    gCountAllocations.store(true);
+    const juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+    synth->processBlock(buffer, midi);
+    const juce::int64 endTicks = juce::Time::getHighResolutionTicks();
+    gCountAllocations.store(false);
+    const juce::int64 blockAllocations = gAllocations.load() - allocationsBefore;
+
+    run.allocations += blockAllocations;
+    run.maxBlockAllocations = juce::jmax(run.maxBlockAllocations, blockAllocations);
+    if (blockStart >= warmupSamples) {
+      run.blockSeconds.push_back(juce::Time::highResolutionTicksToSeconds(endTicks - startTicks));
+      run.timedSamples += numSamples;
+    }
+    if (keepOutput) {
+      for (int ch = 0; ch < numChannels; ++ch) run.output.copyFrom(ch, static_cast<int>(blockStart), buffer, ch, 0, numSamples);
+    }
+  }
+  run.rtViolations = Utils::RtCheck::getNumViolations() - rtViolationsBefore;
+  synth->releaseResources();
+  return true;
+}
+
+juce::DynamicObject::Ptr describeRun(Run& run, const Case& c, double sampleRate) {
+  double total = 0.0;
+  for (double seconds : run.blockSeconds) total += seconds;
+  std::sort(run.blockSeconds.begin(), run.blockSeconds.end());
+  const size_t numTimed = run.blockSeconds.size();
+  const double worst = (numTimed > 0) ? run.blockSeconds.back() : 0.0;
+  const double p99 = (numTimed > 0) ? run.blockSeconds[static_cast<size_t>(0.99 * static_cast<double>(numTimed - 1))] : 0.0;
+  const double deadline = static_cast<double>(c.blockSize) / sampleRate;
+
+  juce::DynamicObject::Ptr result = new juce::DynamicObject();
+  result->setProperty("nsPerSample", run.timedSamples > 0 ? total * 1e9 / static_cast<double>(run.timedSamples) : 0.0);
+  result->setProperty("meanBlockUs", (numTimed > 0) ? total * 1e6 / static_cast<double>(numTimed) : 0.0);
+  result->setProperty("p99BlockUs", p99 * 1e6);
+  result->setProperty("worstBlockUs", worst * 1e6);
+  result->setProperty("worstBlockLoad", worst / deadline);
+  result->setProperty("allocationsPerBlock",
+                      static_cast<double>(run.allocations) / static_cast<double>(juce::jmax(1, run.numBlocks)));
+  result->setProperty("maxBlockAllocations", run.maxBlockAllocations);
+  if (Utils::RtCheck::IS_ACTIVE) result->setProperty("rtViolations", run.rtViolations);
+  return result;
+}
+
+// Largest sample difference and how far below the signal it is
+void compareOutputs(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b, double& maxDiff, double& snrDb) {
+  double signal = 0.0;
+  double noise = 0.0;
+  maxDiff = 0.0;
+  for (int ch = 0; ch < a.getNumChannels(); ++ch) {
+    const float* x = a.getReadPointer(ch);
+    const float* y = b.getReadPointer(ch);
+    for (int i = 0; i < a.getNumSamples(); ++i) {
+      const double diff = static_cast<double>(x[i]) - static_cast<double>(y[i]);
+      maxDiff = juce::jmax(maxDiff, std::abs(diff));
+      signal += static_cast<double>(x[i]) * static_cast<double>(x[i]);
+      noise += diff * diff;
+    }
+  }
+  snrDb = (noise > 0.0) ? 10.0 * std::log10(signal / noise) : std::numeric_limits<double>::infinity();
+}
+
+int runBenchmark(const Options& options) {
+  juce::TemporaryFile source(".wav");
+  Utils::Result result = writeSource(source.getFile(), options.sampleRate);
+  if (!result.success) {
+    std::cerr << result.message << "\n";
+    return 1;
+  }
+
+  std::vector<Case> cases;
+  for (Pattern pattern : options.patterns)
+    for (int voices : options.voices)
+      for (int generators : options.generators)
+        for (int filter : options.filters)
+          for (int sync : options.sync)
+            for (int blockSize : options.blockSizes)
+              cases.push_back({voices, generators, filter != 0, sync != 0, blockSize, pattern});
+
+  const bool printTable = options.jsonPath != "-";
+  if (printTable) {
+    std::cout << "config " << options.config.toString()
+              << (options.compare ? " vs " + options.compareConfig.toString() : juce::String()) << ", " << options.sampleRate
+              << " Hz, " << options.seconds << " s per case\n";
+  }
+
+  juce::Array<juce::var> caseResults;
+  bool allMatch = true;
+  for (const Case& c : cases) {
+    Run run;
+    if (!runCase(options, c, options.config, source.getFile(), options.compare, run)) {
+      std::cerr << "Failed to set up " << c.toString() << "\n";
+      return 1;
+    }
+    juce::DynamicObject::Ptr caseResult = describeRun(run, c, options.sampleRate);
+    caseResult->setProperty("voices", c.voices);
+    caseResult->setProperty("generators", c.generators);
+    caseResult->setProperty("filter", c.filter);
+    caseResult->setProperty("sync", c.sync);
+    caseResult->setProperty("blockSize", c.blockSize);
+    caseResult->setProperty("pattern", c.pattern == Pattern::HELD ? "held" : "retrigger");
+
+    juce::String line = c.toString() + "  | " + juce::String(static_cast<double>(caseResult->getProperty("nsPerSample")), 1) +
+                        " ns/sample  worst " + juce::String(static_cast<double>(caseResult->getProperty("worstBlockUs")), 1) +
+                        " us (" + juce::String(100.0 * static_cast<double>(caseResult->getProperty("worstBlockLoad")), 1) +
+                        "%)  " + juce::String(static_cast<double>(caseResult->getProperty("allocationsPerBlock")), 2) +
+                        " allocs/block";
+    if (Utils::RtCheck::IS_ACTIVE) line += "  " + juce::String(run.rtViolations) + " rt violations";
+
+    if (options.compare) {
+      Run other;
+      if (!runCase(options, c, options.compareConfig, source.getFile(), true, other)) {
+        std::cerr << "Failed to set up " << c.toString() << "\n";
+        return 1;
+      }
+      double maxDiff = 0.0;
+      double snrDb = 0.0;
+      compareOutputs(run.output, other.output, maxDiff, snrDb);
+      const bool match = maxDiff <= options.tolerance;
+      allMatch = allMatch && match;
+      juce::DynamicObject::Ptr otherResult = describeRun(other, c, options.sampleRate);
+      otherResult->setProperty("maxDifference", maxDiff);
+      otherResult->setProperty("snrDb", std::isfinite(snrDb) ? juce::var(snrDb) : juce::var("inf"));
+      otherResult->setProperty("match", match);
+      caseResult->setProperty("compare", juce::var(otherResult.get()));
+      line += "  | vs " + juce::String(static_cast<double>(otherResult->getProperty("nsPerSample")), 1) + " ns/sample, max diff " +
+              juce::String(maxDiff, 9) + (match ? "" : "  MISMATCH");
+    }
+    if (printTable) std::cout << line << std::endl;
+    caseResults.add(juce::var(caseResult.get()));
+  }
+
+  if (options.jsonPath.isNotEmpty()) {
+    juce::DynamicObject::Ptr root = new juce::DynamicObject();
+    root->setProperty("sampleRate", options.sampleRate);
+    root->setProperty("seconds", options.seconds);
+    root->setProperty("seed", options.seed);
+    root->setProperty("numCpus", juce::SystemStats::getNumCpus());
+    root->setProperty("config", options.config.toString());
+    if (options.compare) root->setProperty("compareConfig", options.compareConfig.toString());
+    root->setProperty("cases", caseResults);
+    const juce::String json = juce::JSON::toString(juce::var(root.get()));
+    if (options.jsonPath == "-") {
+      std::cout << json << std::endl;
+    } else if (!juce::File::getCurrentWorkingDirectory().getChildFile(options.jsonPath).replaceWithText(json)) {
+      std::cerr << "Could not write " << options.jsonPath << "\n";
+      return 1;
+    }
+  }
+  if (Utils::RtCheck::getNumViolations() > 0) {
+    std::cerr << Utils::RtCheck::getReport();
+    if (options.rtStrict) return 1;
+  }
+  return allMatch ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  juce::StringArray args;
+  for (int i = 1; i < argc; ++i) args.add(juce::String::fromUTF8(argv[i]));
+
+  Options options;
+  if (!parseOptions(args, options)) {
+    printUsage();
+    return 2;
+  }
+
+  // The synth and its parameters expect a message manager, this doesn't need a display
+  juce::ScopedJuceInitialiser_GUI juceInitialiser;
+  return runBenchmark(options);
+}
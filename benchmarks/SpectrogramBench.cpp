@@ -0,0 +1,223 @@
+/*
+  ==============================================================================
+
+    SpectrogramBench.cpp
+    Created: 19 Oct 2026 4:12:05am
+
+    Times ArcSpectrogram drawing each of its images into an offscreen image
+    at several sizes of the editor, from buffers the real analysis made of a
+    generated clip.
+
+  ==============================================================================
+*/
+
+#include <juce_audio_utils/juce_audio_utils.h>
+
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "Components/ArcSpectrogram.h"
+#include "DSP/GranularSynth.h"
+#include "DSP/PitchDetector.h"
+#include "Utils/FastRandom.h"
+
+namespace {
+
+constexpr double DEFAULT_SAMPLE_RATE = 48000.0;
+constexpr double DEFAULT_SECONDS = 30.0;
+constexpr int DEFAULT_REPEATS = 3;
+constexpr double NOTE_SECONDS = 0.5;
+
+struct Options {
+  // Multiples of the editor's default size, which is what HiDPI screens and the host's zoom end up asking for
+  std::vector<double> scales{1.0, 1.5, 2.0};
+  double sampleRate = DEFAULT_SAMPLE_RATE;
+  double seconds = DEFAULT_SECONDS;
+  int repeats = DEFAULT_REPEATS;
+  juce::File imageDir;    // Also saves the images here when set
+  juce::String jsonPath;  // "-" prints the JSON instead of the table
+};
+
+void printUsage() {
+  std::cout << "Usage: gRainbowSpectrogramBench [options]\n"
+               "\n"
+               "  --scales <list>     Editor sizes as multiples of the default one (default 1,1.5,2)\n"
+               "  --seconds <s>       Length of the analyzed clip (default 30)\n"
+               "  --rate <hz>         Sample rate of the clip (default 48000)\n"
+               "  --repeats <n>       Times each image is drawn, the fastest counts (default 3)\n"
+               "  --images <dir>      Also save the images as .png to check them\n"
+               "  --json <file|->     Write the results as JSON, - prints them instead of the table\n";
+}
+
+bool parseOptions(const juce::StringArray& args, Options& options) {
+  for (int i = 0; i < args.size(); ++i) {
+    const juce::String& arg = args[i];
+    if (arg == "--help" || arg == "-h" || i + 1 >= args.size()) return false;
+    const juce::String value = args[++i];
+    bool valid = true;
+    if (arg == "--scales") {
+      options.scales.clear();
+      for (const juce::String& item : juce::StringArray::fromTokens(value, ",", "")) {
+        options.scales.push_back(item.trim().getDoubleValue());
+        valid = valid && options.scales.back() > 0.0;
+      }
+      valid = valid && !options.scales.empty();
+    } else if (arg == "--seconds") {
+      options.seconds = value.getDoubleValue();
+      valid = options.seconds > 0.0;
+    } else if (arg == "--rate") {
+      options.sampleRate = value.getDoubleValue();
+      valid = options.sampleRate > 0.0;
+    } else if (arg == "--repeats") {
+      options.repeats = value.getIntValue();
+      valid = options.repeats > 0;
+    } else if (arg == "--images") {
+      options.imageDir = juce::File::getCurrentWorkingDirectory().getChildFile(value);
+    } else if (arg == "--json") {
+      options.jsonPath = value;
+    } else {
+      std::cerr << "Unknown option " << arg << "\n";
+      return false;
+    }
+    if (!valid) {
+      std::cerr << "Invalid value for " << arg << ": " << value << "\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+// A harmonic tone on a new random note every half second over a bit of noise, so every image has something in it
+juce::AudioBuffer<float> generateClip(double seconds, double sampleRate) {
+  const int numSamples = static_cast<int>(seconds * sampleRate);
+  juce::AudioBuffer<float> clip(1, numSamples);
+  float* out = clip.getWritePointer(0);
+  Utils::FastRandom random(0);
+  const double twoPi = juce::MathConstants<double>::twoPi;
+  const int noteSamples = static_cast<int>(NOTE_SECONDS * sampleRate);
+  double phase = 0.0;
+  double freq = 220.0;
+  for (int i = 0; i < numSamples; ++i) {
+    if (i % noteSamples == 0) {
+      const int midiNote = PitchDetector::MIN_MIDINOTE + static_cast<int>(random.nextFloat() * 36.0f);
+      freq = juce::MidiMessage::getMidiNoteInHertz(midiNote);
+    }
+    phase += twoPi * freq / sampleRate;
+    double sample = 0.0;
+    for (int h = 1; h <= 6; ++h) sample += std::sin(phase * h) / h;
+    out[i] = static_cast<float>(0.3 * sample) + 0.02f * (random.nextFloat() - 0.5f);
+  }
+  return clip;
+}
+
+int runBenchmark(const Options& options) {
+  if (options.imageDir != juce::File() && !options.imageDir.createDirectory()) {
+    std::cerr << "Could not create " << options.imageDir.getFullPathName() << "\n";
+    return 1;
+  }
+
+  // The same buffers the editor is handed once a file is analyzed
+  juce::AudioBuffer<float> clip = generateClip(options.seconds, options.sampleRate);
+  Fft fft(GranularSynth::FFT_SIZE, GranularSynth::HOP_SIZE, 0.0, 1.0);
+  fft.processSync(&clip);
+  Utils::SpecBuffer spectrogram = fft.getSpectrum();
+  PitchDetector pitchDetector(0.0, 1.0);
+  pitchDetector.computeSpectrum(&clip, options.sampleRate);
+  pitchDetector.computeHPCP();
+  pitchDetector.segmentPitches();
+  pitchDetector.getSegmentedPitchBuffer();
+  Utils::SpecBuffer hpcp = pitchDetector.getHPCP();
+  Utils::SpecBuffer detected = pitchDetector.getSegmentedPitches();
+  pitchDetector.clear();
+
+  std::array<void*, ParamUI::SpecType::COUNT> buffers;
+  buffers[ParamUI::SpecType::SPECTROGRAM] = &spectrogram;
+  buffers[ParamUI::SpecType::HPCP] = &hpcp;
+  buffers[ParamUI::SpecType::DETECTED] = &detected;
+  buffers[ParamUI::SpecType::WAVEFORM] = &clip;
+
+  const bool printTable = options.jsonPath != "-";
+  juce::Array<juce::var> results;
+  for (double scale : options.scales) {
+    // Sized the way the editor lays out the arc, between the side panels and half as tall as it is wide
+    const int width = static_cast<int>(std::round((Utils::EDITOR_WIDTH - 2 * Utils::PANEL_WIDTH) * scale));
+    const int height = width / 2;
+    Parameters parameters;
+    ArcSpectrogram arcSpec(parameters);
+    arcSpec.setSize(width, height);
+
+    for (int type = 0; type < ParamUI::SpecType::COUNT; ++type) {
+      const ParamUI::SpecType specType = static_cast<ParamUI::SpecType>(type);
+      double best = std::numeric_limits<double>::max();
+      double total = 0.0;
+      juce::Image image;
+      for (int repeat = 0; repeat < options.repeats; ++repeat) {
+        const juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+        image = arcSpec.renderImage(specType, buffers[specType]);
+        const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        best = juce::jmin(best, seconds);
+        total += seconds;
+      }
+
+      juce::DynamicObject::Ptr result = new juce::DynamicObject();
+      result->setProperty("specType", Utils::SpecTypeNames[type]);
+      result->setProperty("width", width);
+      result->setProperty("height", height);
+      result->setProperty("bestMs", best * 1e3);
+      result->setProperty("meanMs", total * 1e3 / options.repeats);
+      results.add(juce::var(result.get()));
+      if (printTable) {
+        std::cout << juce::String(width) << "x" << juce::String(height) << "  " << Utils::SpecTypeNames[type].paddedRight(' ', 18)
+                  << juce::String(best * 1e3, 1).paddedLeft(' ', 8) << " ms best  "
+                  << juce::String(total * 1e3 / options.repeats, 1).paddedLeft(' ', 8) << " ms mean\n";
+      }
+
+      if (options.imageDir != juce::File()) {
+        const juce::File file = options.imageDir.getChildFile(Utils::SpecTypeNames[type].removeCharacters(" ") + "_" +
+                                                              juce::String(width) + "x" + juce::String(height) + ".png");
+        file.deleteFile();
+        juce::FileOutputStream outStream(file);
+        juce::PNGImageFormat png;
+        if (!outStream.openedOk() || !png.writeImageToStream(image, outStream)) {
+          std::cerr << "Could not write " << file.getFullPathName() << "\n";
+          return 1;
+        }
+      }
+    }
+  }
+
+  if (options.jsonPath.isNotEmpty()) {
+    juce::DynamicObject::Ptr root = new juce::DynamicObject();
+    root->setProperty("clipSeconds", options.seconds);
+    root->setProperty("sampleRate", options.sampleRate);
+    root->setProperty("images", results);
+    const juce::String json = juce::JSON::toString(juce::var(root.get()));
+    if (options.jsonPath == "-") {
+      std::cout << json << std::endl;
+    } else if (!juce::File::getCurrentWorkingDirectory().getChildFile(options.jsonPath).replaceWithText(json)) {
+      std::cerr << "Could not write " << options.jsonPath << "\n";
+      return 1;
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  juce::StringArray args;
+  for (int i = 1; i < argc; ++i) args.add(juce::String::fromUTF8(argv[i]));
+
+  Options options;
+  if (!parseOptions(args, options)) {
+    printUsage();
+    return 2;
+  }
+
+  // Components need a message manager and a default look and feel, drawing into an image doesn't need a display
+  juce::ScopedJuceInitialiser_GUI juceInitialiser;
+  return runBenchmark(options);
+}
@@ -0,0 +1,331 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026 2:08:51am
+
+    Headless renderer, plays a MIDI file through the synth and writes the
+    result to an audio file. Runs without a display so it can be used for
+    batch renders on servers and for profiling processBlock outside a DAW.
+
+  ==============================================================================
+*/
+
+#include <juce_audio_utils/juce_audio_utils.h>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "DSP/GranularSynth.h"
+#include "Utils/RtCheck.h"
+
+namespace {
+
+constexpr double DEFAULT_SAMPLE_RATE = 48000.0;
+constexpr int DEFAULT_BLOCK_SIZE = 512;
+constexpr double DEFAULT_TAIL_SECONDS = 3.0;
+constexpr int DEFAULT_BIT_DEPTH = 24;
+// How long to wait for the source levels to be built before giving up
+constexpr int SOURCE_TIMEOUT_MS = 60000;
+
+struct Options {
+  juce::File preset;
+  juce::File state;
+  juce::File audio;
+  juce::File midi;
+  juce::File out;
+  double sampleRate = DEFAULT_SAMPLE_RATE;
+  int blockSize = DEFAULT_BLOCK_SIZE;
+  int threads = 0;  // 0 keeps whatever the render mode picks
+  bool hasSeed = false;
+  juce::int64 seed = 0;
+  bool deterministic = false;
+  bool realtime = false;
+  double tailSeconds = DEFAULT_TAIL_SECONDS;
+  int bitDepth = DEFAULT_BIT_DEPTH;
+  bool quiet = false;
+  bool rtStrict = false;
+};
+
+void printUsage() {
+  std::cout << "Usage: gRainbowRender (--preset file.gbow | --state state.bin [--audio file.wav]) --midi file.mid --out file.wav\n"
+               "\n"
+               "  --preset <file>     .gbow preset to play\n"
+               "  --state <file>      Plugin state saved by the standalone app (\"Save current state\")\n"
+               "  --audio <file>      Audio file to use in place of the one the state was saved with\n"
+               "  --midi <file>       Standard MIDI file to play, all tracks are merged\n"
+               "  --out <file>        Output file, the format follows the extension (.wav or .flac)\n"
+               "  --rate <hz>         Sample rate to render at (default 48000)\n"
+               "  --block <samples>   Block size processBlock is called with (default 512)\n"
+               "  --threads <n>       Render threads including the main one (default: all cores offline, 1 with --realtime)\n"
+               "  --seed <n>          Project seed for the grain spray, implies --deterministic\n"
+               "  --deterministic     Same MIDI and seed always render the same samples\n"
+               "  --realtime          Render as a live host would instead of as an offline bounce\n"
+               "  --tail <seconds>    Time rendered after the last MIDI event (default 3)\n"
+               "  --bits <16|24|32>   Output bit depth (default 24)\n"
+               "  --quiet             Only print errors\n"
+               "  --rt-strict         Fail if processBlock allocates or locks, needs a GRAINBOW_RT_CHECK build\n";
+}
+
+bool parseOptions(const juce::StringArray& args, Options& options) {
+  for (int i = 0; i < args.size(); ++i) {
+    const juce::String& arg = args[i];
+    const bool hasValue = (i + 1 < args.size());
+    const juce::String value = hasValue ? args[i + 1] : juce::String();
+    const juce::File file = hasValue ? juce::File::getCurrentWorkingDirectory().getChildFile(value) : juce::File();
+
+    if (arg == "--deterministic") {
+      options.deterministic = true;
+      continue;
+    } else if (arg == "--realtime") {
+      options.realtime = true;
+      continue;
+    } else if (arg == "--quiet") {
+      options.quiet = true;
+      continue;
+    } else if (arg == "--rt-strict") {
+      options.rtStrict = true;
+      continue;
+    } else if (arg == "--help" || arg == "-h") {
+      return false;
+    }
+
+    if (!hasValue) {
+      std::cerr << "Missing value for " << arg << "\n";
+      return false;
+    }
+    if (arg == "--preset") {
+      options.preset = file;
+    } else if (arg == "--state") {
+      options.state = file;
+    } else if (arg == "--audio") {
+      options.audio = file;
+    } else if (arg == "--midi") {
+      options.midi = file;
+    } else if (arg == "--out") {
+      options.out = file;
+    } else if (arg == "--rate") {
+      options.sampleRate = value.getDoubleValue();
+    } else if (arg == "--block") {
+      options.blockSize = value.getIntValue();
+    } else if (arg == "--threads") {
+      options.threads = value.getIntValue();
+    } else if (arg == "--seed") {
+      options.hasSeed = true;
+      options.seed = value.getLargeIntValue();
+      options.deterministic = true;
+    } else if (arg == "--tail") {
+      options.tailSeconds = value.getDoubleValue();
+    } else if (arg == "--bits") {
+      options.bitDepth = value.getIntValue();
+    } else {
+      std::cerr << "Unknown option " << arg << "\n";
+      return false;
+    }
+    ++i;
+  }
+
+  if (options.preset == juce::File() && options.state == juce::File()) {
+    std::cerr << "Either --preset or --state is needed\n";
+    return false;
+  }
+  if (options.midi == juce::File() || options.out == juce::File()) {
+    std::cerr << "Both --midi and --out are needed\n";
+    return false;
+  }
+  if (options.rtStrict && !Utils::RtCheck::IS_ACTIVE) {
+    std::cerr << "--rt-strict needs a build configured with -DGRAINBOW_RT_CHECK=ON on Linux\n";
+    return false;
+  }
+  if (options.sampleRate <= 0.0 || options.blockSize <= 0 || options.tailSeconds < 0.0) {
+    std::cerr << "Sample rate and block size must be positive and the tail can't be negative\n";
+    return false;
+  }
+  return true;
+}
+
+Utils::Result loadSynth(GranularSynth& synth, const Options& options) {
+  if (options.preset != juce::File()) return synth.loadPreset(options.preset);
+
+  juce::MemoryBlock stateData;
+  if (!options.state.loadFileAsData(stateData)) return {false, "Could not read " + options.state.getFullPathName()};
+  if (options.audio != juce::File()) {
+    // Point the state at the other file so it is loaded and trimmed the same way a saved session would be
+    std::unique_ptr<juce::XmlElement> xml = juce::AudioProcessor::getXmlFromBinary(stateData.getData(),
+                                                                                   static_cast<int>(stateData.getSize()));
+    juce::XmlElement* ui = (xml != nullptr) ? xml->getChildByName("ParamUI") : nullptr;
+    if (ui == nullptr) return {false, options.state.getFullPathName() + " is not a gRainbow state"};
+    ui->setAttribute("fileName", options.audio.getFullPathName());
+    stateData.reset();
+    juce::AudioProcessor::copyXmlToBinary(*xml, stateData);
+  }
+  synth.setStateInformation(stateData.getData(), static_cast<int>(stateData.getSize()));
+  return {true, ""};
+}
+
+Utils::Result loadMidi(const juce::File& file, juce::MidiMessageSequence& sequence) {
+  juce::FileInputStream input(file);
+  if (!input.openedOk()) return {false, "Could not open " + file.getFullPathName()};
+  juce::MidiFile midiFile;
+  if (!midiFile.readFrom(input)) return {false, file.getFullPathName() + " is not a standard MIDI file"};
+  midiFile.convertTimestampTicksToSeconds();
+  for (int track = 0; track < midiFile.getNumTracks(); ++track) {
+    sequence.addSequence(*midiFile.getTrack(track), 0.0);
+  }
+  sequence.sort();
+  return {true, ""};
+}
+
+void printStats(std::vector<double>& blockSeconds, double blockDeadline, double audioSeconds) {
+  if (blockSeconds.empty()) return;
+  double total = 0.0;
+  for (double seconds : blockSeconds) total += seconds;
+  std::sort(blockSeconds.begin(), blockSeconds.end());
+  const auto percentile = [&blockSeconds](double p) {
+    const size_t index = static_cast<size_t>(p * static_cast<double>(blockSeconds.size() - 1) + 0.5);
+    return blockSeconds[index];
+  };
+  const auto toUs = [](double seconds) { return juce::String(seconds * 1e6, 1) + " us"; };
+  const double mean = total / static_cast<double>(blockSeconds.size());
+
+  std::cout << "Blocks:     " << blockSeconds.size() << " (" << toUs(blockDeadline) << " deadline each)\n"
+            << "Block time: min " << toUs(blockSeconds.front()) << ", mean " << toUs(mean) << ", p50 " << toUs(percentile(0.5))
+            << ", p99 " << toUs(percentile(0.99)) << ", max " << toUs(blockSeconds.back()) << "\n"
+            << "Load:       mean " << juce::String(100.0 * mean / blockDeadline, 1) << "%, max "
+            << juce::String(100.0 * blockSeconds.back() / blockDeadline, 1) << "% of the deadline\n"
+            << "Rendered " << juce::String(audioSeconds, 2) << " s of audio in " << juce::String(total, 2) << " s ("
+            << juce::String(audioSeconds / juce::jmax(total, 1e-9), 1) << "x real time)\n";
+}
+
+int render(const Options& options) {
+  GranularSynth synth;
+
+  Utils::Result result = loadSynth(synth, options);
+  if (!result.success) {
+    std::cerr << result.message << "\n";
+    return 1;
+  }
+  juce::MidiMessageSequence sequence;
+  result = loadMidi(options.midi, sequence);
+  if (!result.success) {
+    std::cerr << result.message << "\n";
+    return 1;
+  }
+
+  // What was given on the command line wins over what the preset or state was saved with
+  ParamEngine& engine = synth.getParams().engine;
+  if (options.hasSeed) engine.seed.store(options.seed);
+  if (options.deterministic) engine.deterministic.store(true);
+
+  const int numChannels = synth.getTotalNumOutputChannels();
+  synth.setNonRealtime(!options.realtime);
+  if (options.threads > 0) synth.setNumRenderThreads(options.threads);
+  synth.setRateAndBufferSizeDetails(options.sampleRate, options.blockSize);
+  synth.prepareToPlay(options.sampleRate, options.blockSize);
+
+  if (!synth.getParamUI().specComplete) {
+    std::cerr << "The source was never analyzed, there are no pitches to play. Save the state after the analysis finished.\n";
+    return 1;
+  }
+  // Grains only read the decimated levels once they're built, wait so the render doesn't depend on how fast that was
+  const juce::uint32 waitStart = juce::Time::getMillisecondCounter();
+  while (!synth.isSourceReady()) {
+    if (juce::Time::getMillisecondCounter() - waitStart > SOURCE_TIMEOUT_MS) {
+      std::cerr << "Timed out preparing the source\n";
+      return 1;
+    }
+    juce::Thread::sleep(5);
+  }
+
+  const double lastEventSeconds = (sequence.getNumEvents() > 0) ? sequence.getEndTime() : 0.0;
+  const juce::int64 totalSamples = static_cast<juce::int64>((lastEventSeconds + options.tailSeconds) * options.sampleRate);
+  const int numBlocks = static_cast<int>((totalSamples + options.blockSize - 1) / options.blockSize);
+
+  juce::AudioFormatManager formatManager;
+  formatManager.registerBasicFormats();
+  juce::AudioFormat* format = formatManager.findFormatForFileExtension(options.out.getFileExtension());
+  if (format == nullptr) {
+    std::cerr << "Can't write " << options.out.getFileExtension() << " files, use .wav or .flac\n";
+    return 1;
+  }
+  options.out.deleteFile();
+  std::unique_ptr<juce::FileOutputStream> outStream = options.out.createOutputStream();
+  if (outStream == nullptr) {
+    std::cerr << "Could not create " << options.out.getFullPathName() << "\n";
+    return 1;
+  }
+  std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(
+      outStream.get(), options.sampleRate, static_cast<unsigned int>(numChannels), options.bitDepth, {}, 0));
+  if (writer == nullptr) {
+    std::cerr << "The output format doesn't support " << options.bitDepth << " bit at " << options.sampleRate << " Hz\n";
+    return 1;
+  }
+  outStream.release();  // Owned by the writer now
+
+  juce::AudioBuffer<float> buffer(numChannels, options.blockSize);
+  juce::MidiBuffer midiBuffer;
+  std::vector<double> blockSeconds;
+  blockSeconds.reserve(static_cast<size_t>(numBlocks));
+  int nextEvent = 0;
+  // Only what happens inside processBlock from here on counts
+  Utils::RtCheck::reset();
+
+  for (int block = 0; block < numBlocks; ++block) {
+    const juce::int64 blockStart = static_cast<juce::int64>(block) * options.blockSize;
+    const int numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(options.blockSize), totalSamples - blockStart));
+
+    // Events that fall in this block, at their offset into it
+    midiBuffer.clear();
+    while (nextEvent < sequence.getNumEvents()) {
+      const juce::MidiMessage& message = sequence.getEventPointer(nextEvent)->message;
+      const juce::int64 eventSample = static_cast<juce::int64>(message.getTimeStamp() * options.sampleRate);
+      if (eventSample >= blockStart + numSamples) break;
+      if (!message.isMetaEvent()) {
+        midiBuffer.addEvent(message, static_cast<int>(juce::jmax(static_cast<juce::int64>(0), eventSample - blockStart)));
+      }
+      ++nextEvent;
+    }
+
+    buffer.setSize(numChannels, numSamples, false, false, true);
+    buffer.clear();
+    const juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+    synth.processBlock(buffer, midiBuffer);
+    blockSeconds.push_back(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks));
+
+    writer->writeFromAudioSampleBuffer(buffer, 0, numSamples);
+  }
+  writer.reset();
+  synth.releaseResources();
+
+  if (!options.quiet) {
+    std::cout << "Wrote " << options.out.getFullPathName() << " (" << numChannels << " ch, " << options.sampleRate << " Hz, "
+              << options.blockSize << " sample blocks, " << synth.getNumRenderThreads() << " render threads"
+              << (engine.deterministic.load() ? ", deterministic seed " + juce::String(engine.seed.load()) : juce::String())
+              << ")\n";
+    printStats(blockSeconds, static_cast<double>(options.blockSize) / options.sampleRate,
+               static_cast<double>(totalSamples) / options.sampleRate);
+  }
+  if (Utils::RtCheck::getNumViolations() > 0) {
+    std::cerr << Utils::RtCheck::getReport();
+    if (options.rtStrict) return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  juce::StringArray args;
+  for (int i = 1; i < argc; ++i) args.add(juce::String::fromUTF8(argv[i]));
+
+  Options options;
+  if (!parseOptions(args, options)) {
+    printUsage();
+    return 2;
+  }
+
+  // The synth and its parameters expect a message manager, this doesn't need a display
+  juce::ScopedJuceInitialiser_GUI juceInitialiser;
+  return render(options);
+}